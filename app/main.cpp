@@ -12,32 +12,58 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 
 #include "bitreeviz/BiTreeViz.h"
 
+#include <algorithm>
+#include <cctype>
 #include <cmath>
 #include <iostream>
 #include <string>
 #include <vector>
 
-bool ParsingUserInput(int argc, char **argv, std::string &inputFile, std::string &outputFile);
+bool ParsingUserInput(int argc, char **argv, std::string &inputFile, std::string &outputFile, uint32_t &dpi, bool &hasError);
+bool IsPngFile(const std::string &file);
 
 int main(int argc, char *argv[])
 {
 	std::string inputFile;
 	std::string outputFile;
+	uint32_t dpi = bitree::PngDpiDefault;
+	bool hasError = false;
 
-	if (ParsingUserInput(argc, argv, inputFile, outputFile))
+	if (argc >= 3 && std::string(argv[1]) == "--check")
+	{
+		std::vector<std::string> inputFiles(argv + 2, argv + argc);
+		return bitree::BiTreeViz::check(inputFiles) ? 0 : 1;
+	}
+
+	if (argc >= 3 && std::string(argv[1]) == "--stats")
+	{
+		std::vector<std::string> inputFiles(argv + 2, argv + argc);
+		return bitree::BiTreeViz::stats(inputFiles) ? 0 : 1;
+	}
+
+	if (argc >= 3 && std::string(argv[1]) == "--batch")
+	{
+		std::vector<std::string> inputFiles(argv + 2, argv + argc);
+		return bitree::BiTreeViz::batch(inputFiles) ? 0 : 1;
+	}
+
+	if (ParsingUserInput(argc, argv, inputFile, outputFile, dpi, hasError))
 	{
 		bitree::BiTreeViz bitreeViz(inputFile, outputFile);
-		return (int)bitreeViz.run();
+		bitreeViz.setDpi(dpi);
+		return bitreeViz.run() ? 0 : 1;
 	}
 
-	return 0;
+	// The help and version are not errors, an invalid parameter is.
+	return hasError ? 1 : 0;
 }
 
-bool ParsingUserInput(int argc, char **argv, std::string &inputFile, std::string &outputFile)
+bool ParsingUserInput(int argc, char **argv, std::string &inputFile, std::string &outputFile, uint32_t &dpi, bool &hasError)
 {
 	inputFile.clear();
 	outputFile.clear();
 	bool hasTask = false;
+	hasError = false;
 
 	if (argc == 1)
 	{
@@ -66,10 +92,52 @@ bool ParsingUserInput(int argc, char **argv, std::string &inputFile, std::string
 		outputFile = argv[3];
 		hasTask = true;
 	}
+	else if (argc == 6 && (std::string(argv[2]) == "-o") && (std::string(argv[4]) == "--dpi") && !IsPngFile(argv[3]))
+	{
+		printf("bitreeviz: --dpi is only for a png output, [%s] is not a [.png] file.\n", argv[3]);
+		hasError = true;
+	}
+	else if (argc == 6 && (std::string(argv[2]) == "-o") && (std::string(argv[4]) == "--dpi"))
+	{
+		const std::string str = argv[5];
+		unsigned long value = 0;
+		std::size_t length = 0;
+		try
+		{
+			value = std::stoul(str, &length);
+		}
+		catch (...)
+		{
+			length = 0;
+		}
+
+		if (length == str.size() && value >= bitree::PngDpiMin && value <= bitree::PngDpiMax)
+		{
+			inputFile = argv[1];
+			outputFile = argv[3];
+			dpi = (uint32_t)value;
+			hasTask = true;
+		}
+		else
+		{
+			printf("bitreeviz: invalid dpi [%s], it should be %u to %u.\n", argv[5], bitree::PngDpiMin, bitree::PngDpiMax);
+			hasError = true;
+		}
+	}
 	else
 	{
 		printf("bitreeviz: invalid parameter input.\n");
+		hasError = true;
 	}
 
 	return hasTask;
 }
+
+bool IsPngFile(const std::string &file)
+{
+	static const std::string suffix = ".png";
+	return file.size() > suffix.size() &&
+		   std::equal(suffix.rbegin(), suffix.rend(), file.rbegin(), [](char a, char b) {
+			   return a == std::tolower((unsigned char)b);
+		   });
+}
@@ -0,0 +1,167 @@
+/*
+The MIT License
+
+Copyright 2021 Krishna sssky307@163.com
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#pragma once
+
+#include "BiTreeLayouter.h"
+#include "BiTreeParser.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace bitree
+{
+/**
+ * @brief Build a bitree in memory without writing and parsing the bitree text.
+ * After building, the follow information can be used to render a bitree.
+ * 1, all node's property in getNodeInfoArray();
+ * 2, all node's position and page-info in getLayoutInfo().
+ */
+class BiTreeBuilder
+{
+public:
+	using NodeHandle = uint32_t;
+	static constexpr NodeHandle NodeHandleInvalid = UINT32_MAX; ///< Means no node, such as an empty child.
+
+public:
+	BiTreeBuilder();
+	~BiTreeBuilder();
+
+	/**
+	 * @brief Create a node, the node has no parent and no children after created.
+	 * 
+	 * @param label 		Node's label.
+	 * @return NodeHandle 	Handle of the new node, NodeHandleInvalid if the label is invalid.
+	 */
+	NodeHandle createNode(const std::string& label);
+
+	/**
+	 * @brief Set the children of a node.
+	 * A child must not have a parent already, and must not be an ancestor of the node.
+	 * 
+	 * @param node 			The parent node.
+	 * @param leftChild 	Left child, NodeHandleInvalid means empty.
+	 * @param rightChild 	Right child, NodeHandleInvalid means empty.
+	 * @return true 		Set pass.
+	 * @return false 		Set failed.
+	 */
+	bool setChildren(NodeHandle node, NodeHandle leftChild, NodeHandle rightChild);
+
+	/**
+	 * @brief Reset the label of a node.
+	 * 
+	 * @param node 		The node.
+	 * @param label 	New label.
+	 * @return true 	Set pass.
+	 * @return false 	Set failed.
+	 */
+	bool setLabel(NodeHandle node, const std::string& label);
+
+	/**
+	 * @brief Set a node scope property, it is the same as [NodeLabel{PropertyName = PropertyValue}].
+	 * The property is attached to the node directly, so the label can be any string.
+	 * 
+	 * @param node 				The node.
+	 * @param propertyName 		Property name, such as "FillColor".
+	 * @param propertyValue 	Property value, such as "0xff0000ff".
+	 * @return true 			Set pass.
+	 * @return false 			Set failed.
+	 */
+	bool setNodeProperty(NodeHandle node,
+						 const std::string& propertyName,
+						 const std::string& propertyValue);
+
+	/**
+	 * @brief Set a global scope property of this bitree, it is the same as [[PropertyName = PropertyValue]].
+	 * 
+	 * @param propertyName 		Property name, such as "PageBackgroundColor".
+	 * @param propertyValue 	Property value, such as "0x000000ee".
+	 * @return true 			Set pass.
+	 * @return false 			Set failed.
+	 */
+	bool setGlobalProperty(const std::string& propertyName, const std::string& propertyValue);
+
+	/**
+	 * @brief Bulk build a bitree from arrays, all nodes created before are dropped.
+	 * Node i has label labels[i], left child leftChildren[i] and right child rightChildren[i],
+	 * the children are indexes of the arrays, NodeHandleInvalid means empty.
+	 * The returned handle of node i is i.
+	 * 
+	 * @param labels 			Labels of all nodes.
+	 * @param leftChildren 		Left child index of all nodes.
+	 * @param rightChildren 	Right child index of all nodes.
+	 * @return true 			Build pass.
+	 * @return false 			Build failed.
+	 */
+	bool buildFromArrays(const std::vector<std::string>& labels,
+						 const std::vector<NodeHandle>& leftChildren,
+						 const std::vector<NodeHandle>& rightChildren);
+
+	/**
+	 * @brief Bulk build a bitree from a level-order array(the heap layout), all nodes created before are dropped.
+	 * Node i's children are node 2i+1 and node 2i+2, an element equal to emptyLabel means empty.
+	 * The returned handle of node i is i.
+	 * 
+	 * @param labels 		Labels of all nodes in level-order.
+	 * @param emptyLabel 	Label used to mark an empty node.
+	 * @return true 		Build pass.
+	 * @return false 		Build failed.
+	 */
+	bool buildFromLevelOrder(const std::vector<std::string>& labels,
+							 const std::string& emptyLabel = "");
+
+	/**
+	 * @brief Layout the bitree from root, it should be used after building.
+	 * The node and global properties are resolved here, so they should be set before layout.
+	 * 
+	 * @param root 		Root of the bitree, default is the first created node.
+	 * @return true 	Layout pass.
+	 * @return false 	Layout failed.
+	 */
+	bool layout(NodeHandle root = 0);
+
+	/**
+	 * @brief It stores all node properties set by the builder.
+	 * 
+	 * @return const NodeInfoArray* 	Array of NodeInfo.
+	 */
+	const NodeInfoArray* getNodeInfoArray() const;
+
+	/**
+	 * @brief It stores all node labels of the built bitree.
+	 * 
+	 * @return const LabelPool* 	Label pool, BiTreeNode::labelId is index to it.
+	 */
+	const LabelPool* getLabelPool() const;
+
+	/**
+	 * @brief Get the Layout Info, it should be used after layout.
+	 * 
+	 * @return LayoutInfo Layout Info.
+	 */
+	const BiTreeLayouter::LayoutInfo& getLayoutInfo();
+
+private:
+	std::vector<BiTreeParser::BiTreeNode*> mNodeArray;
+	NodeInfoArray* mNodeInfoArray = nullptr;
+	BiTreePropertyManager* mPropertyManager = nullptr; ///< Global properties of this bitree.
+	LabelPool* mLabelPool = nullptr;
+	BiTreeLayouter* mBiTreeLayouter = nullptr;
+
+	bool isNodeHandleValid(NodeHandle node) const;
+	bool isLabelValid(const std::string& label) const;
+	bool isAncestor(const BiTreeParser::BiTreeNode* node, const BiTreeParser::BiTreeNode* child) const;
+	void clear();
+}; // BiTreeBuilder-define-end
+} // namespace bitree
@@ -0,0 +1,63 @@
+/*
+The MIT License
+
+Copyright 2021 Krishna sssky307@163.com
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace bitree
+{
+/**
+ * @brief Map node values to colors through a gradient, such as "viridis" or "0x0000ffff 0xff0000ff".
+ * The gradient is sampled to a lookup table once, so mapping all the nodes is one loop without branches.
+ */
+class BiTreeColorMap
+{
+public:
+	static constexpr uint32_t StopCountMax = 16;
+	static constexpr uint32_t TableSize = 256;
+
+	/**
+	 * @brief Load a gradient, it is a built-in name or 2 to 16 colors separated by spaces.
+	 * 
+	 * @param gradient 	Input gradient string.
+	 * @return true 	Valid.
+	 * @return false 	Invalid, nothing is changed.
+	 */
+	bool load(std::string_view gradient);
+
+	/**
+	 * @brief Map the values in [valueMin, valueMax] to colors, a value out of the range is clamped.
+	 * 
+	 * @param valueArray 	Input values.
+	 * @param valueMin 		The value mapped to the first color of the gradient.
+	 * @param valueMax 		The value mapped to the last color of the gradient.
+	 * @param colorArray 	Output colors with the same size as valueArray, the format is 0xRRGGBBAA.
+	 */
+	void map(const std::vector<double>& valueArray,
+			 double valueMin,
+			 double valueMax,
+			 std::vector<uint32_t>& colorArray) const;
+
+	/**
+	 * @brief Check a gradient string without loading it, it is the checker of the color map properties.
+	 */
+	static bool isGradientValid(std::string_view gradient);
+
+private:
+	std::array<uint32_t, TableSize> mColorTable{};
+}; // BiTreeColorMap-define-end
+} // namespace bitree
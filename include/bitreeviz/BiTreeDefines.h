@@ -12,10 +12,15 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 
 #pragma once
 
-#include <any>
+#include <charconv>
 #include <cstdint>
-#include <set>
+#include <cstdio>
+#include <deque>
+#include <functional>
 #include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
 
 namespace bitree
 {
@@ -24,6 +29,9 @@ constexpr uint32_t NodeIdMin = 0;
 constexpr uint32_t NodeIdMax = 0xfffffff0;
 constexpr uint32_t NodeIdInvalid = NodeIdMax + 1;
 
+// Max length of a node's data(the NodeId or label string in the bitree).
+constexpr uint32_t NodeDataStrLenMax = 256;
+
 // Common values.
 constexpr uint32_t DefaultWhiteColor = 0xffffffff;
 constexpr uint32_t DefaultBlackColor = 0x000000ff;
@@ -55,6 +63,12 @@ constexpr uint32_t BorderWidthMax = 12;
 constexpr uint32_t BorderDashStringLengthMin = 1;
 constexpr uint32_t BorderDashStringLengthMax = 255;
 
+constexpr uint32_t DashUnitMin = 1;
+constexpr uint32_t DashUnitMax = 255;
+
+// Id of the parsed units of a dash string in the dash pool of BiTreePropertyManager, 0 is no dash.
+constexpr uint32_t DashIdNone = 0;
+
 constexpr uint32_t FillColorDefault = 0;
 
 constexpr uint32_t EdgeColorDefault = DefaultBlackColor;
@@ -114,8 +128,34 @@ constexpr uint32_t PageMarginXIncrementMax = 255;
 constexpr uint32_t PageMarginYIncrementDefault = 0;
 constexpr uint32_t PageMarginYIncrementMin = 0;
 constexpr uint32_t PageMarginYIncrementMax = 255;
+
+// 
+// The node values are mapped to colors by FillColorMap and BorderColorMap, a map is a gradient:
+// Gradient ::= "gray" | "heat" | "viridis" | "coolwarm" | Color [SpaceChar Color]+
+// The value of a node is its ColorMapValue, or its NodeId if ColorMapValue is not set.
+// 
+constexpr uint32_t ColorMapValueDefault = UINT32_MAX; // Not set, the NodeId is mapped.
+constexpr uint32_t ColorMapValueMin = 0;
+constexpr uint32_t ColorMapValueMax = UINT32_MAX - 1;
+
+#define ColorMapDefault ""
+constexpr uint32_t ColorMapStringLengthMin = 1;
+constexpr uint32_t ColorMapStringLengthMax = 255;
+
+// The range mapped to the gradient, a bound not set is the min or max value of all the nodes.
+constexpr uint32_t ColorMapMinDefault = UINT32_MAX; // Not set.
+constexpr uint32_t ColorMapMinMin = 0;
+constexpr uint32_t ColorMapMinMax = UINT32_MAX - 1;
+constexpr uint32_t ColorMapMaxDefault = UINT32_MAX; // Not set.
+constexpr uint32_t ColorMapMaxMin = 0;
+constexpr uint32_t ColorMapMaxMax = UINT32_MAX - 1;
 // Property-define-end.
 
+// Resolution of the png output, a page unit is 1/72 inch.
+constexpr uint32_t PngDpiDefault = 96;
+constexpr uint32_t PngDpiMin = 18;
+constexpr uint32_t PngDpiMax = 1200;
+
 //
 // Macro defines----------------------------
 //
@@ -124,11 +164,22 @@ constexpr uint32_t PageMarginYIncrementMax = 255;
 #	define USING_BITREE_PRINT
 #endif
 
+/**
+ * @brief Stream of all the logs, it is stdout by default.
+ * It should be stderr when stdout is used to output data, such as the rendered file.
+ * Every thread has its own stream, so a document rendered in one thread does not redirect the others.
+ */
+inline FILE*& PrintStream()
+{
+	static thread_local FILE* printStream = stdout;
+	return printStream;
+}
+
 #ifdef USING_BITREE_PRINT
 #define PrintInfo(fmt, ...)                                                                        \
 	do                                                                                             \
 	{																							   \
-		fprintf(stdout, "[info]: " fmt, ##__VA_ARGS__);                                             \
+		fprintf(::bitree::PrintStream(), "[info]: " fmt, ##__VA_ARGS__);                            \
 	} while(0)
 #endif
 
@@ -136,7 +187,7 @@ constexpr uint32_t PageMarginYIncrementMax = 255;
 #define PrintError(fmt, ...)                                                                       \
 	do                                                                                             \
 	{                                                                                              \
-		fprintf(stdout, "[error]: " fmt, ##__VA_ARGS__);                                             \
+		fprintf(::bitree::PrintStream(), "[error]: " fmt, ##__VA_ARGS__);                           \
 	} while(0)
 #endif
 
@@ -155,167 +206,506 @@ constexpr uint32_t PageMarginYIncrementMax = 255;
 using str_ptr_t = std::string::const_iterator;
 
 /**
- * @brief Holding a BitreeNode's all property values.
+ * @brief Store each distinct label string once in a contiguous arena.
+ * A label is referenced by its 32-bit label id, so nodes with the same label share one copy.
  */
-class NodeInfo
+class LabelPool
 {
 public:
+	static constexpr uint32_t LabelIdInvalid = UINT32_MAX;
+
+private:
+	std::vector<char> mArena; 				// All label chars, one label after another.
+	std::vector<uint32_t> mOffsetArray; 	// Label i is [mOffsetArray[i], mOffsetArray[i+1]) of mArena.
+	std::vector<uint32_t> mSlotArray; 		// Open-addressing hash slots, each holds a label id.
+	std::vector<uint32_t> mNodeIdArray; 	// NodeId of each label, NodeIdInvalid if the label is not a number.
+	uint32_t mMaxLabelSize;
+
+	std::size_t getSlot(std::string_view label) const
+	{
+		// mSlotArray.size() is always power of 2.
+		std::size_t mask = mSlotArray.size() - 1;
+		std::size_t slot = std::hash<std::string_view>{}(label) & mask;
+
+		while(mSlotArray[slot] != LabelIdInvalid && get(mSlotArray[slot]) != label)
+		{
+			slot = (slot + 1) & mask;
+		}
+
+		return slot;
+	}
+
+	void rehash(std::size_t slotSize)
+	{
+		mSlotArray.assign(slotSize, LabelIdInvalid);
+		for(uint32_t id = 0; id < size(); id++)
+		{
+			mSlotArray[getSlot(get(id))] = id;
+		}
+	}
+
+public:
+	LabelPool()
+		: mOffsetArray{0}
+		, mSlotArray(64, LabelIdInvalid)
+		, mMaxLabelSize(0)
+	{ }
+
 	/**
-	 * @brief One element store one unique property.
+	 * @brief Add a label to the pool if it is not exist.
+	 * 
+	 * @param label 		Input label.
+	 * @return uint32_t 	Label id of the label.
 	 */
-	struct element_t
+	uint32_t intern(std::string_view label)
 	{
-		uint32_t index; ///< Property-index of propertyTable of BiTreePropertyManager.
-		mutable std::any value; ///< Hold any property-value.
-
-		bool operator<(const element_t& other) const
+		auto slot = getSlot(label);
+		if(mSlotArray[slot] != LabelIdInvalid)
 		{
-			return this->index < other.index;
+			return mSlotArray[slot];
 		}
 
-		element_t()
-			: index(UINT32_MAX){};
+		uint32_t id = size();
+		mArena.insert(mArena.end(), label.begin(), label.end());
+		mOffsetArray.push_back((uint32_t)mArena.size());
+		mNodeIdArray.push_back(toNodeId(label));
+		mSlotArray[slot] = id;
 
-		element_t(const uint32_t& index, const std::any& value)
-			: index(index)
-			, value(value)
-		{ }
-	}; //Element-define-end.
+		if(mMaxLabelSize < label.size())
+		{
+			mMaxLabelSize = (uint32_t)label.size();
+		}
 
-private:
-	uint32_t mNodeId; // Unique nodeId of a BiTreeNode.
-	mutable std::set<element_t> mElementSet; 	// All properties.
-	mutable uint32_t mElementSetSizeCurrent;	// Just for speeding-up when getting mElementSet size.
-	static const uint32_t mElementSetSizeMax = 32;
+		// Keep load factor under 0.5.
+		if(size() * 2 > mSlotArray.size())
+		{
+			rehash(mSlotArray.size() * 2);
+		}
 
-public:
-	const std::set<element_t>& getElementSet()const
+		return id;
+	}
+
+	/**
+	 * @brief Find a label in the pool.
+	 * 
+	 * @param label 		Input label.
+	 * @return uint32_t 	Label id of the label, LabelIdInvalid if not exist.
+	 */
+	uint32_t find(std::string_view label) const
 	{
-		return mElementSet;
+		return mSlotArray[getSlot(label)];
 	}
-    const uint32_t& getNodeId()const
+
+	/**
+	 * @brief Get label string by label id.
+	 * The returned string_view is invalid after any new label is interned.
+	 * 
+	 * @param id 	Label id.
+	 * @return std::string_view 	The label.
+	 */
+	std::string_view get(uint32_t id) const
 	{
-		return mNodeId;
+		BiTreeAssert(id < size());
+		return std::string_view(mArena.data() + mOffsetArray[id], mOffsetArray[id + 1] - mOffsetArray[id]);
 	}
 
-	void setNodeId(const uint32_t& nodeId)
+	/**
+	 * @brief Get the NodeId of a label, it is classified once when the label is interned.
+	 * 
+	 * @param id 			Label id.
+	 * @return uint32_t 	NodeId of the label, NodeIdInvalid if the label is not a number.
+	 */
+	uint32_t getNodeId(uint32_t id) const
 	{
-		mNodeId=nodeId;
+		BiTreeAssert(id < size());
+		return mNodeIdArray[id];
 	}
 
-	void clear()
+	uint32_t size() const
 	{
-		mNodeId=UINT32_MAX;
-		mElementSet.clear();
-		mElementSetSizeCurrent=0;
+		return (uint32_t)(mOffsetArray.size() - 1);
 	}
 
-	uint32_t& getElementSetSizeCurrentRef()
+	uint32_t getMaxLabelSize() const
 	{
-		return mElementSetSizeCurrent;
+		return mMaxLabelSize;
 	}
 
-	bool empty() const
+	void clear()
 	{
-		return mElementSet.empty();
+		mArena.clear();
+		mOffsetArray.assign(1, 0);
+		mNodeIdArray.clear();
+		mSlotArray.assign(64, LabelIdInvalid);
+		mMaxLabelSize = 0;
 	}
 
-	bool insert(const element_t& element)
+	/**
+	 * @brief Convert a label to NodeId without exception, such as "12" or "0x1f".
+	 * Only these labels can be used as index to NodeInfo, other labels such as "abc" or "1f" are strings.
+	 * 
+	 * @param label 		Input label.
+	 * @return uint32_t 	NodeId, NodeIdInvalid if the label is not a number or out of range.
+	 */
+	static uint32_t toNodeId(std::string_view label)
 	{
-		if(mElementSetSizeCurrent < mElementSetSizeMax)
+		int base = 10;
+		auto begin = label.data();
+		auto end = label.data() + label.size();
+
+		if(label.size() > 2 && label[0] == '0' && (label[1] == 'x' || label[1] == 'X'))
 		{
-			++mElementSetSizeCurrent;
-			mElementSet.insert(element);
+			base = 16;
+			begin += 2;
+		}
 
-			return true;
+		// std::from_chars() accepts "-", but a NodeId cannot have it.
+		if(begin == end || *begin == '-')
+		{
+			return NodeIdInvalid;
 		}
 
-		PrintError("ElementSet size overflow, [mElementSetSizeMax]=%d.\n",mElementSetSizeMax);
-		return false;
+		uint32_t nodeId = NodeIdInvalid;
+		auto result = std::from_chars(begin, end, nodeId, base);
+		if(result.ec != std::errc() || result.ptr != end || nodeId > NodeIdMax)
+		{
+			return NodeIdInvalid;
+		}
+
+		return nodeId;
 	}
-	bool operator<(const NodeInfo& other) const
+}; // LabelPool-define-end
+
+// Count of properties in propertyTable of BiTreePropertyManager.
+constexpr uint32_t PropertyCount = 25;
+
+/**
+ * @brief A checked property value, the number of a Uint32 property or the string of a String property.
+ */
+struct PropertyValue
+{
+	uint32_t number = 0;
+	std::string string;
+	bool isString = false;
+	uint32_t dashId = DashIdNone; ///< Dash id of a BorderDash or EdgeDash string, parsed when it is checked.
+};
+
+/**
+ * @brief Holding a BitreeNode's all property values.
+ * Each property has a fixed slot indexed by its property-index, the presence mask tells which slots are set.
+ * A Uint32 value is stored as it is, a String value is stored as its string id of NodeInfoArray.
+ */
+class NodeInfo
+{
+private:
+	uint32_t mNodeId; 					// Unique nodeId of a BiTreeNode.
+	uint32_t mPresenceMask; 			// Bit i is set if the slot i has a value.
+	uint32_t mValueArray[PropertyCount];
+
+	static_assert(PropertyCount <= 32, "Presence mask can not hold all properties.");
+
+public:
+	NodeInfo(const uint32_t& nodeId = UINT32_MAX)
+		: mNodeId(nodeId)
+		, mPresenceMask(0)
+		, mValueArray{}
+	{ }
+
+	const uint32_t& getNodeId() const
+	{
+		return mNodeId;
+	}
+
+	void setNodeId(const uint32_t& nodeId)
+	{
+		mNodeId = nodeId;
+	}
+
+	void clear()
 	{
-		return this->mNodeId < other.mNodeId;
+		mNodeId = UINT32_MAX;
+		mPresenceMask = 0;
 	}
 
-	NodeInfo(const uint32_t& nodeId=UINT32_MAX)
-		: mNodeId(nodeId),mElementSetSizeCurrent(0){};
+	bool empty() const
+	{
+		return mPresenceMask == 0;
+	}
+
+	/**
+	 * @brief Check if a property has a value.
+	 * 
+	 * @param index 	Property-index of propertyTable of BiTreePropertyManager.
+	 */
+	bool has(const uint32_t& index) const
+	{
+		BiTreeAssert(index < PropertyCount);
+		return (mPresenceMask >> index) & 1;
+	}
+
+	/**
+	 * @brief Get the value of a property, it must has a value.
+	 * 
+	 * @param index 		Property-index of propertyTable of BiTreePropertyManager.
+	 * @return uint32_t 	The number, or the string id of a String property.
+	 */
+	uint32_t get(const uint32_t& index) const
+	{
+		BiTreeAssert(has(index));
+		return mValueArray[index];
+	}
+
+	/**
+	 * @brief Set the value of a property, the old value is replaced so the last one takes effect.
+	 * 
+	 * @param index 	Property-index of propertyTable of BiTreePropertyManager.
+	 * @param value 	The number, or the string id of a String property.
+	 */
+	void set(const uint32_t& index, const uint32_t& value)
+	{
+		BiTreeAssert(index < PropertyCount);
+		mValueArray[index] = value;
+		mPresenceMask |= (1u << index);
+	}
+
+	/**
+	 * @brief Set all the values of another NodeInfo, they take effect over the values of this one.
+	 * 
+	 * @param other 	Input NodeInfo, its NodeId is not used.
+	 */
+	void merge(const NodeInfo& other)
+	{
+		for(uint32_t index = 0; index < PropertyCount; index++)
+		{
+			if(other.has(index))
+			{
+				set(index, other.mValueArray[index]);
+			}
+		}
+	}
 }; // NodeInfo-define-end
 
+/**
+ * @brief Properties of a selector line, such as @depth 3 [FillColor=0xff0000ff].
+ * A selector matches nodes by their NodeId or by their position in the bitree, so one line can style many nodes.
+ */
+struct NodeSelector
+{
+	enum class Type : uint8_t
+	{
+		Range, 		///< @range first-last, nodes with NodeId in [first, last].
+		Depth, 		///< @depth first-last, nodes with depth in [first, last], the depth of root is 0.
+		Leaf, 		///< @leaf, nodes without child.
+		Internal, 	///< @internal, nodes with any child.
+		Subtree 	///< @subtree first, the node with NodeId first and all its descendants.
+	};
+
+	Type type = Type::Range;
+	uint32_t first = 0;
+	uint32_t last = 0;
+	NodeInfo nodeInfo; ///< Properties set to the matched nodes.
+};
+
 /**
  * @brief Holding all nodeinfo of a bitree.
  */
 class NodeInfoArray
 {
 private:
-	std::set<NodeInfo> mNodeInfoSet;
-    mutable uint32_t mNodeInfoSetSizeCurrent; // Just for speeding-up when getting size of nodeInfoSet.
-	static const uint32_t mNodeInfoSetSizeMax = NodeIdMax;
+	std::vector<NodeInfo> mNodeInfoArray; 						// NodeInfo indexed by NodeId.
+	std::unordered_map<uint32_t, uint32_t> mNodeInfoIndexMap; 	// NodeId to the index of mNodeInfoArray.
+	LabelPool mNodeLabelPool; 									// String NodeIds, such as abc.
+	std::vector<uint32_t> mNodeLabelIndexArray; 				// Label id of mNodeLabelPool to the index of mNodeInfoArray.
+	std::unordered_map<uint32_t, uint32_t> mInheritedIndexMap; 	// The same as mNodeInfoIndexMap, for inherited NodeInfo.
+	std::vector<uint32_t> mInheritedLabelIndexArray; 			// The same as mNodeLabelIndexArray, for inherited NodeInfo.
+	std::deque<NodeInfo> mInlineNodeInfoArray; 	// NodeInfo attached to a node directly, not indexed by NodeId.
+	std::vector<NodeSelector> mSelectorArray; 	// Selector lines in the order they are parsed.
+	LabelPool mStringPool; 						// All String values, each distinct string is stored once.
+	std::vector<uint32_t> mDashIdArray; 		// String id of mStringPool to its dash id, for the dash strings.
 
 public:
-	NodeInfoArray()
-	:mNodeInfoSetSizeCurrent(0)
-	{ }
-	bool
-	insertNodeInfo(const uint32_t& nodeId, const uint32_t& elementIndex, const std::any& elementValue)
+	/**
+	 * @brief Check if there is no NodeInfo indexed by NodeId.
+	 */
+	bool empty() const
 	{
-		NodeInfo nodeInfo(nodeId);
-		NodeInfo::element_t element(elementIndex, elementValue);
+		return mNodeInfoArray.empty();
+	}
 
-		auto it1 = mNodeInfoSet.find(nodeInfo);
-		if(it1 != mNodeInfoSet.end())
+	/**
+	 * @brief Set a checked property value to a NodeInfo, a String value is stored in this NodeInfoArray.
+	 * 
+	 * @param nodeInfo 		The NodeInfo, it should be owned by this NodeInfoArray or added to it later.
+	 * @param elementIndex 	Property-index of propertyTable of BiTreePropertyManager.
+	 * @param value 		The checked value.
+	 */
+	void setValue(NodeInfo& nodeInfo, const uint32_t& elementIndex, const PropertyValue& value)
+	{
+		if(!value.isString)
 		{
-			return const_cast<NodeInfo&>(*it1).insert(element);
+			nodeInfo.set(elementIndex, value.number);
+			return;
 		}
-		else
+
+		auto stringId = mStringPool.intern(value.string);
+		if(value.dashId != DashIdNone)
 		{
-			// Not find this nodeInfo, insert new NodeInfo.
-			nodeInfo.insert(element);
-			return this->insertNodeInfo(nodeInfo);
+			if(stringId >= mDashIdArray.size())
+			{
+				mDashIdArray.resize(stringId + 1, DashIdNone);
+			}
+			mDashIdArray[stringId] = value.dashId;
 		}
+		nodeInfo.set(elementIndex, stringId);
+	}
+
+	/**
+	 * @brief Get a String value by the string id stored in a NodeInfo.
+	 * The returned string_view is invalid after any new String value is set.
+	 */
+	std::string_view getString(const uint32_t& stringId) const
+	{
+		return mStringPool.get(stringId);
+	}
+
+	/**
+	 * @brief Get the dash id of a String value by its string id, DashIdNone if it is not a dash string.
+	 */
+	uint32_t getDashId(const uint32_t& stringId) const
+	{
+		return stringId < mDashIdArray.size() ? mDashIdArray[stringId] : DashIdNone;
+	}
+
+	/**
+	 * @brief Store the inline properties of a node, such as 1{FillColor=0xff0000ff} in the bitree.
+	 * The returned pointer keeps valid until clearInlineNodeInfo() is called.
+	 * 
+	 * @param nodeInfo 			Input NodeInfo, its NodeId is not used.
+	 * @return NodeInfo* 		Stored NodeInfo.
+	 */
+	NodeInfo* addInlineNodeInfo(NodeInfo&& nodeInfo)
+	{
+		mInlineNodeInfoArray.push_back(std::move(nodeInfo));
+		return &mInlineNodeInfoArray.back();
 	}
 
-	bool insertNodeInfo(const NodeInfo& nodeInfo)
+	void clearInlineNodeInfo()
 	{
-		if(mNodeInfoSetSizeCurrent<mNodeInfoSetSizeMax)
+		mInlineNodeInfoArray.clear();
+	}
+
+	/**
+	 * @brief Store a selector line, the selectors parsed later take effect over the earlier ones.
+	 * 
+	 * @param selector 	Input selector with its properties.
+	 */
+	void addSelector(NodeSelector&& selector)
+	{
+		mSelectorArray.push_back(std::move(selector));
+	}
+
+	const std::vector<NodeSelector>& getSelectorArray() const
+	{
+		return mSelectorArray;
+	}
+
+	/**
+	 * @brief Set a property value to the NodeInfo of a NodeId, the NodeInfo is added if not exist.
+	 * 
+	 * @param nodeId 		Input NodeId.
+	 * @param elementIndex 	Property-index of propertyTable of BiTreePropertyManager.
+	 * @param value 		The checked value.
+	 * @param isInherited 	The value is inherited by the descendants of the node, it is stored apart.
+	 */
+	void insertNodeInfo(const uint32_t& nodeId,
+						const uint32_t& elementIndex,
+						const PropertyValue& value,
+						bool isInherited = false)
+	{
+		auto& indexMap = (isInherited ? mInheritedIndexMap : mNodeInfoIndexMap);
+		auto result = indexMap.emplace(nodeId, (uint32_t)mNodeInfoArray.size());
+		if(result.second)
 		{
-			++mNodeInfoSetSizeCurrent;
-			mNodeInfoSet.insert(nodeInfo);
-			return true;
+			mNodeInfoArray.emplace_back(nodeId);
 		}
-		PrintError("mNodeInfoSet overflow, [mNodeInfoSetSizeMax]=%d\n",mNodeInfoSetSizeMax);
 
-		return false;
+		setValue(mNodeInfoArray[result.first->second], elementIndex, value);
 	}
 
-	const NodeInfo& findNodeInfo(const std::string& NodeIdStr)const
+	/**
+	 * @brief Set a property value to the NodeInfo of a string NodeId, the NodeInfo is added if not exist.
+	 * 
+	 * @param nodeLabel 	Input string NodeId, it is a label that is not a number, such as abc.
+	 * @param elementIndex 	Property-index of propertyTable of BiTreePropertyManager.
+	 * @param value 		The checked value.
+	 * @param isInherited 	The value is inherited by the descendants of the node, it is stored apart.
+	 */
+	void insertNodeInfo(std::string_view nodeLabel,
+						const uint32_t& elementIndex,
+						const PropertyValue& value,
+						bool isInherited = false)
 	{
-		static NodeInfo tempNodeInfo;
-		uint32_t inputNodeId;
-		bool good=true;
-
-		try
+		auto labelId = mNodeLabelPool.intern(nodeLabel);
+		auto& indexArray = (isInherited ? mInheritedLabelIndexArray : mNodeLabelIndexArray);
+		if(labelId >= indexArray.size())
 		{
-			inputNodeId=(uint32_t)std::stoul(NodeIdStr,nullptr,0);
+			indexArray.resize(labelId + 1, UINT32_MAX);
 		}
-		catch(...)
+		if(indexArray[labelId] == UINT32_MAX)
 		{
-			good=false;
+			indexArray[labelId] = (uint32_t)mNodeInfoArray.size();
+			mNodeInfoArray.emplace_back(NodeIdInvalid);
 		}
-	
-		if(good)
+
+		setValue(mNodeInfoArray[indexArray[labelId]], elementIndex, value);
+	}
+
+	/**
+	 * @brief Find the NodeInfo of a NodeId.
+	 * The returned pointer is invalid after any new NodeId is inserted.
+	 * 
+	 * @param nodeId 			Input NodeId.
+	 * @param isInherited 		Find the inherited NodeInfo or not.
+	 * @return const NodeInfo* 	The NodeInfo, nullptr if not found.
+	 */
+	const NodeInfo* findNodeInfo(const uint32_t& nodeId, bool isInherited = false) const
+	{
+		auto& indexMap = (isInherited ? mInheritedIndexMap : mNodeInfoIndexMap);
+		auto it = indexMap.find(nodeId);
+		if(it != indexMap.end())
 		{
-			tempNodeInfo.setNodeId(inputNodeId);
-			auto it=mNodeInfoSet.find(tempNodeInfo);
-			if(it!=mNodeInfoSet.end())
-			{
-				return *it;
-			}
+			return &mNodeInfoArray[it->second];
+		}
+
+		return nullptr;
+	}
+
+	/**
+	 * @brief Find the NodeInfo of a string NodeId.
+	 * The returned pointer is invalid after any new NodeId is inserted.
+	 * 
+	 * @param nodeLabel 		Input string NodeId.
+	 * @param isInherited 		Find the inherited NodeInfo or not.
+	 * @return const NodeInfo* 	The NodeInfo, nullptr if not found.
+	 */
+	const NodeInfo* findNodeInfo(std::string_view nodeLabel, bool isInherited = false) const
+	{
+		auto& indexArray = (isInherited ? mInheritedLabelIndexArray : mNodeLabelIndexArray);
+		auto labelId = mNodeLabelPool.find(nodeLabel);
+		if(labelId < indexArray.size() && indexArray[labelId] != UINT32_MAX)
+		{
+			return &mNodeInfoArray[indexArray[labelId]];
 		}
-		
-		tempNodeInfo.setNodeId(NodeIdInvalid);
 
-		return tempNodeInfo;
+		return nullptr;
+	}
+
+	/**
+	 * @brief Check if any NodeInfo is inherited, such as @inherit 5 [FillColor=0xff0000ff].
+	 */
+	bool hasInheritedNodeInfo() const
+	{
+		return !mInheritedIndexMap.empty() || !mInheritedLabelIndexArray.empty();
 	}
 
 }; //NodeInfoArray-define-end
@@ -14,11 +14,16 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 
 #include "BiTreeLayouter.h"
 #include "BiTreeParser.h"
+#include "BiTreeScanner.h"
+#include "BiTreeStats.h"
+#include "BiTreeStylesheet.h"
 
 #include <string>
 
 namespace bitree
 {
+class BiTreeInputStream;
+
 	/**
 	 * @brief Parsing user input file.
 	 * After parsing, the follow information can be used to render a bitree.
@@ -41,6 +46,25 @@ public:
 	~BiTreeFileParser();
 	bool parsing();
 
+	/**
+	 * @brief Check the grammar of the bitree and all the property lines.
+	 * It does not build any BiTreeNode, the memory is O(depth) of the bitree.
+	 * 
+	 * @return true 	Check pass.
+	 * @return false 	Check failed.
+	 */
+	bool checking();
+
+	/**
+	 * @brief Collect the statistics of the bitree in one pass, property lines are not read.
+	 * It does not build any BiTreeNode, the memory is O(depth) of the bitree.
+	 * 
+	 * @param stats 	Store the statistics.
+	 * @return true 	The bitree is valid.
+	 * @return false 	The bitree has error(s).
+	 */
+	bool statistics(BiTreeStats& stats);
+
 	const NodeInfoArray* getNodeInfoArray();
 
 	/**
@@ -50,9 +74,6 @@ public:
 	 */
 	const BiTreeLayouter::LayoutInfo& getLayoutInfo();
 
-private:
-	FileParserInfo mFileParserInfo;
-
 	/**
 	 * @brief Trim a file-line text.
 	 * Trim the font spaces and the back spaces and notes.
@@ -61,8 +82,13 @@ private:
 	 * @param end Pointer to string buffer end.
 	 * @return trimed start pos.
 	 */
-	std::string::const_iterator trimLine(std::string::const_iterator& begin,
-										 std::string::const_iterator& end);
+	static std::string::const_iterator trimLine(std::string::const_iterator& begin,
+												std::string::const_iterator& end);
+
+private:
+	static const std::size_t PropertyChunkLineCount = 16 * 1024; // Lines parsed by a worker thread at a time.
+
+	FileParserInfo mFileParserInfo;
 
 	/**
 	 * @brief Trim off the file's start token before the bitree's real begin.
@@ -75,5 +101,41 @@ private:
 	std::string::const_iterator trimStartToken(std::string::const_iterator begin,
 											   std::string::const_iterator end,
 											   bool& status);
+
+	/**
+	 * @brief Scan the input file char by char, the bitree text is sent to the scanner.
+	 * 
+	 * @param scanner 				Scanner for the bitree text.
+	 * @param isCheckingProperty 	Check property lines after the bitree or not.
+	 * @return true 				Scan pass.
+	 * @return false 				Scan failed.
+	 */
+	bool scanning(BiTreeScanner& scanner, bool isCheckingProperty);
+
+	/**
+	 * @brief Parsing the property lines after the bitree line.
+	 * A long property section is split into chunks of lines, they are parsed on worker threads,
+	 * then applied in the order of the lines, so the last property still takes effect.
+	 * 
+	 * @param firstLine 		The first line after the bitree line.
+	 * @param inFile 			Input file to read the rest lines.
+	 * @param propertyParser 	Apply the properties to it.
+	 * @return true 			Parsing pass.
+	 * @return false 			Parsing failed.
+	 */
+	bool parsingProperties(const std::string& firstLine,
+						   BiTreeInputStream& inFile,
+						   BiTreeParser::BiTreePropertyParser* propertyParser);
+
+	/**
+	 * @brief Handle an include line: @include "file", the stylesheet is parsed only once in a process.
+	 * 
+	 * @param begin 			Begin of the trimmed line, it should be "@".
+	 * @param end 				End of the whole line.
+	 * @param propertyParser 	Apply the stylesheet to it, nullptr to check the stylesheet only.
+	 * @return true 			Include pass.
+	 * @return false 			Include failed.
+	 */
+	bool including(str_ptr_t begin, str_ptr_t end, BiTreeParser::BiTreePropertyParser* propertyParser);
 }; // BiTreeFileParser-end
 } // namespace bitree
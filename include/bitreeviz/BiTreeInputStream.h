@@ -0,0 +1,118 @@
+/*
+The MIT License
+
+Copyright 2021 Krishna sssky307@163.com
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#pragma once
+
+#include <cstddef>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace bitree
+{
+/**
+ * @brief Read user input file chunk by chunk.
+ * Gzip(and zstd if it is supported at build time) compressed file is detected by its magic bytes
+ * and decompressed on the fly, so the peak memory is bounded by the chunk size.
+ */
+class BiTreeInputStream
+{
+public:
+	enum class Compression
+	{
+		None,
+		Gzip,
+		Zstd
+	};
+
+	static const std::size_t ChunkSize = 64 * 1024;
+
+public:
+	BiTreeInputStream(const std::string& inputFile);
+	~BiTreeInputStream();
+
+	/**
+	 * @brief Open the input file and detect its compression.
+	 * 
+	 * @return true 	Open pass.
+	 * @return false 	Open failed.
+	 */
+	bool open();
+
+	/**
+	 * @brief Read next line, the line does not contain the char '\n'.
+	 * 
+	 * @param line 		Store the line.
+	 * @return true 	Get a line.
+	 * @return false 	End of file or error, check good() for error.
+	 */
+	bool getLine(std::string& line);
+
+	/**
+	 * @brief Read next char.
+	 * 
+	 * @param ch 		Store the char.
+	 * @return true 	Get a char.
+	 * @return false 	End of file or error, check good() for error.
+	 */
+	bool getChar(char& ch)
+	{
+		if(mOutBegin == mOutEnd && !fill())
+		{
+			return false;
+		}
+		ch = mOutBuffer[mOutBegin++];
+		return true;
+	}
+
+	/**
+	 * @brief Check if there is no read or decompress error.
+	 */
+	bool good() const;
+
+	Compression getCompression() const;
+
+private:
+	std::string mInputFile;
+	FILE* mFile = nullptr; 			// It is stdin if the input file is "-".
+	Compression mCompression = Compression::None;
+	bool mIsGood = false;
+	bool mIsInputEnd = false;
+	bool mIsFrameEnd = true; 		// Compressed data stops at the end of a gzip member or zstd frame.
+
+	std::vector<char> mInBuffer; 	// Raw chunk read from file.
+	std::size_t mInBegin = 0;
+	std::size_t mInEnd = 0;
+	std::vector<char> mOutBuffer; 	// Decompressed chunk.
+	std::size_t mOutBegin = 0;
+	std::size_t mOutEnd = 0;
+	void* mDecoder = nullptr; 		// z_stream or ZSTD_DStream.
+
+	/**
+	 * @brief Read next raw chunk from file into mInBuffer.
+	 */
+	bool readChunk();
+
+	/**
+	 * @brief Refill mOutBuffer with next decompressed chunk.
+	 * 
+	 * @return true 	Get some data.
+	 * @return false 	End of file or error.
+	 */
+	bool fill();
+
+	bool fillGzip();
+	bool fillZstd();
+	void close();
+}; // BiTreeInputStream-define-end
+} // namespace bitree
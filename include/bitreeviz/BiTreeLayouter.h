@@ -13,6 +13,7 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 #pragma once
 
 #include "BiTreeParser.h"
+#include "BiTreePropertyManager.h"
 
 #include <cstddef>
 #include <cstdint>
@@ -33,18 +34,23 @@ public:
     * @brief Constructer
     * 
     * @param radius Input node radius for layout, all node's radius are all the same size.
+    * @param propertyManager The property context of the document, it should live until layout() is done.
     */
-	BiTreeLayouter(const double& radius);
+	BiTreeLayouter(const double& radius, BiTreePropertyManager* propertyManager);
 	~BiTreeLayouter();
 
 	/**
     * @brief Main layout function.
     * 
     * @param root The bitree will be layouted.
+    * @param labelPool The bitree's node labels.
+    * @param nodeInfoArray The bitree's node properties, they are resolved to LayoutInfo::styleArray.
     * @return true Layout pass.
     * @return false Layout failed.
     */
-	bool layout(BiTreeParser::BiTreeNode* root);
+	bool layout(BiTreeParser::BiTreeNode* root,
+				const LabelPool* labelPool,
+				const NodeInfoArray* nodeInfoArray);
    
    /**
     * @brief Get the Internal LayoutInfo.
@@ -56,6 +62,7 @@ public:
 
 private:
 	LayoutInfo* mLayoutInfo = nullptr;
+	BiTreePropertyManager* mPropertyManager = nullptr;
 	LayoutInfo* getLayoutInfo();
 	double offsetH();
 	double offsetV();
@@ -146,6 +153,15 @@ private:
    */
 	void finalInitXYCoordinate(BiTreeParser::BiTreeNode* node);
 
+	/**
+   * @brief Resolve the global properties and the NodeInfo of every node to its NodeProperty once,
+   * so the renderer only reads them. Equal NodeProperty are interned to one style.
+   * The inherited properties and selectors are resolved in the same top-down pass.
+   *
+   * @param nodeInfoArray The bitree's node properties.
+   */
+	void resolveStyle(const NodeInfoArray* nodeInfoArray);
+
 public:
 	struct LayoutInfo
 	{
@@ -158,6 +174,7 @@ public:
 			, pageheight(0.0f)
 			, raduis(0.0f)
          ,treeOffsetX(0.0f)
+         ,labelPool(nullptr)
 		{ }
 		double offset_h_; ///< Horizontal offset between two nodes;
 		double offset_v_; ///< Vertical offset between two nodes;
@@ -168,6 +185,9 @@ public:
 		double raduis; ///< Node radius.
       double treeOffsetX;
 		std::vector<BiTreeParser::BiTreeNode*> bitreeNodeArray;
+      const LabelPool* labelPool; ///< BiTreeNode::labelId is index to it.
+      std::vector<BiTreePropertyManager::NodeProperty> styleArray; ///< Distinct resolved NodeProperty, styleArray[0] is the global one.
+      std::vector<uint32_t> nodeStyleArray; ///< Index to styleArray of each node in bitreeNodeArray.
 
       // Convert BitreeNode's x to absolute x for drawing.
       double toAbsoluteX(double bitreeNodeX)const
@@ -13,8 +13,8 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 #pragma once
 
 #include "BiTreeDefines.h"
+#include "BiTreePropertyManager.h"
 
-#include <any>
 #include <cstdint>
 #include <set>
 #include <string>
@@ -31,6 +31,19 @@ public:
 	struct BiTreeNode;
 	class BiTreePropertyParser
 	{
+	public:
+		/**
+		 * @brief One parsed [PropertyName = PropertyValue], it is checked and typed, so it can be applied later.
+		 */
+		struct Record
+		{
+			uint32_t nodeId; 		///< NodeId of the property line, NodeIdInvalid for global scope property.
+			uint32_t elementIndex; 	///< Property-index of propertyTable of BiTreePropertyManager.
+			PropertyValue value; 	///< Checked property value.
+			std::string nodeLabel; 	///< String NodeId of the property line, such as abc, it is empty for a number NodeId.
+			bool isInherited; 		///< It is an @inherit line, the property is inherited by the descendants.
+		};
+
 	public:
 		BiTreePropertyParser();
 		~BiTreePropertyParser();
@@ -52,8 +65,62 @@ public:
 	 */
 		const NodeInfoArray* getNodeInfoArray() const;
 
+	/**
+	 * @brief Can be used to get the global properties of this document after parsing.
+	 * 
+	 * @return BiTreePropertyManager* 	Property context of this document.
+	 */
+		BiTreePropertyManager* getPropertyManager();
+
+	/**
+	 * @brief Only check the property lines, nothing is printed or saved.
+	 * 
+	 * @param isCheckOnly 	Check only or not.
+	 */
+		void setCheckOnly(bool isCheckOnly);
+
+	/**
+	 * @brief Do not print the parsed properties, the errors are still printed.
+	 * 
+	 * @param isQuiet 	Quiet or not.
+	 */
+		void setQuiet(bool isQuiet);
+
+	/**
+	 * @brief Parsing the inline properties of a node, such as {FillColor=0xff0000ff, EdgeWidth=2}.
+	 * Only node scope properties can be used inline.
+	 * 
+	 * @param begin 	Begin of the inline properties, it should be "{".
+	 * @param end 		End of the bitree text.
+	 * @param status 	Store result, true if parsing pass.
+	 * @param nodeInfo 	Store the parsed properties, it is nullptr in check-only mode.
+	 * @return str_ptr_t 	Position after "}".
+	 */
+		str_ptr_t parsingInline(str_ptr_t begin, str_ptr_t end, bool& status, const NodeInfo*& nodeInfo);
+
+	/**
+	 * @brief Append the parsed properties to the record array instead of applying them.
+	 * 
+	 * @param recordArray 	Record array, nullptr to apply the parsed properties again.
+	 */
+		void setRecordArray(std::vector<Record>* recordArray);
+
+	/**
+	 * @brief Apply the records, it is the same as parsing their property lines again.
+	 * 
+	 * @param recordArray 	Records from setRecordArray().
+	 * @return true 		Apply pass.
+	 * @return false 		Apply failed.
+	 */
+		bool apply(const std::vector<Record>& recordArray);
+
 	private:
 		NodeInfoArray* mNodeInfoArray = nullptr;
+		BiTreePropertyManager* mPropertyManager = nullptr;
+		bool mIsCheckOnly = false;
+		bool mIsQuiet = false;
+		std::vector<Record>* mRecordArray = nullptr;
+		char mValueEndChar = ']'; // A value without quotes ends before it.
 		static const std::size_t maxTokenStringSizeAllowed = 255;
 
 		bool is_char_09(const char& ch);
@@ -69,6 +136,17 @@ public:
 
 		str_ptr_t getNodeId(str_ptr_t begin, str_ptr_t end, bool& status, std::string& nodeId);
 
+		/**
+		 * @brief Check if it is an inherit line, such as @inherit 5 [FillColor = 0xff0000ff].
+		 */
+		bool isInheritLine(str_ptr_t begin, str_ptr_t end);
+
+		str_ptr_t getSelector(str_ptr_t begin,
+							  str_ptr_t end,
+							  bool& status,
+							  NodeSelector& selector,
+							  std::string& selectorStr);
+
 		str_ptr_t
 		getPropertyName(str_ptr_t begin, str_ptr_t end, bool& status, std::string& propertyName);
 
@@ -132,11 +210,19 @@ public:
 	 */
 	const NodeInfoArray* getNodeInfoArray() const;
 
+	/**
+	 * @brief It stores all node labels of the parsed bitree.
+	 * 
+	 * @return const LabelPool* 	Label pool, BiTreeNode::labelId is index to it.
+	 */
+	const LabelPool* getLabelPool() const;
+
 private:
 	BiTreeNode* mRoot = nullptr;
 	BiTreePropertyParser* mPropertyParser = nullptr;
+	LabelPool* mLabelPool = nullptr;
 
-	static std::size_t maxTokenSizeCurrent;
+	std::size_t maxTokenSizeCurrent = 0;
 	static const std::size_t maxTokenSizeAllowed;
 
 	enum class TokenName
@@ -151,22 +237,27 @@ private:
 		Int
 	};
 
-	using value_t = std::string;
 	struct Token
 	{
 		TokenName name;
-		value_t value;
+		uint32_t labelId; ///< Label id in mLabelPool, only used by TokenName::Int.
+		const NodeInfo* nodeInfo; ///< Inline properties, only used by TokenName::Int.
 		Token()
 			: name(TokenName::Unknown)
+			, labelId(LabelPool::LabelIdInvalid)
+			, nodeInfo(nullptr)
 		{ }
 		Token(const TokenName& name)
 		{
 			this->name = name;
+			this->labelId = LabelPool::LabelIdInvalid;
+			this->nodeInfo = nullptr;
 		}
-		Token(const TokenName& name, const value_t& value)
+		Token(const TokenName& name, const uint32_t& labelId)
 		{
 			this->name = name;
-			this->value = value;
+			this->labelId = labelId;
+			this->nodeInfo = nullptr;
 		}
 		bool operator==(const Token& other) const
 		{
@@ -198,6 +289,15 @@ private:
 		return mTokenArrayBuffer[(uint32_t)(token.name)];
 	}
 
+	std::string getTokenValueStr(const Token& token)
+	{
+		if(token.name == TokenName::Int && token.labelId != LabelPool::LabelIdInvalid)
+		{
+			return std::string(mLabelPool->get(token.labelId));
+		}
+		return getTokenNameStr(token);
+	}
+
 	using TokenArray = std::vector<Token>;
 	TokenArray getTokenArray(const std::string& text);
 	ActionType action(const Token& token, const Token& token1, const Token& token2);
@@ -212,8 +312,8 @@ public:
 	{
 		BiTreeNode* leftChild; ///< Left child of this node;
 		BiTreeNode* rightChild; ///< Right child of this node;
-		std::string data;
-
+		uint32_t labelId; ///< Label id in the LabelPool of its parser.
+		const NodeInfo* nodeInfo; ///< Inline properties of this node, nullptr if it has none.
 
 		// Follow properties will be runtime generated when do layout work.
 		double x; ///< X-coordinate.
@@ -221,42 +321,13 @@ public:
 		double subTreeOffsetX; ///< Offset of this tree.
 		BiTreeNode* parent; ///< Point to parent.
 
-		BiTreeNode(const std::string& data)
+		BiTreeNode(const uint32_t& labelId)
 		{
-			this->data = data;
+			this->labelId = labelId;
+			this->nodeInfo = nullptr;
 			this->parent = this->leftChild = this->rightChild = nullptr;
 			x = y = subTreeOffsetX = 0.0f;
 		}
-
-		std::string dataToString()
-		{
-			return data;
-		}
-
-		bool isDataDecimalOrHexNumber()
-		{
-			bool isDigitNumber = false;
-			auto begin = this->data.begin();
-			auto end = this->data.end();
-
-			if(begin<end && (begin+1)<end && *begin=='0' && (*(begin+1)=='x' ||*(begin+1)=='X'))
-			{
-				begin+=2;
-			}
-
-			while(begin<end && ('0'<=*begin && *begin<='9' || 'a'<=*begin && *begin<='f' || 'A'<=*begin && *begin<='F'))
-			{
-				++begin;
-				isDigitNumber=true;
-			}
-
-			if(begin<end)
-			{
-				isDigitNumber=false;
-			}
-
-			return isDigitNumber;
-		}
 	}; //BiTreeNode-define-end.
 }; // BiTreeParser=define-end
 } // namespace bitree
@@ -14,8 +14,9 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 
 #include "BiTreeDefines.h"
 
-#include <any>
 #include <string>
+#include <string_view>
+#include <tuple>
 #include <vector>
 
 namespace bitree
@@ -39,6 +40,9 @@ public:
 			, edgeWidth(EdgeWidthDefault)
 			, edgeDash(EdgeDashDefault)
 			, fontColor(FontColorDefault)
+			, colorMapValue(ColorMapValueDefault)
+			, borderDashId(DashIdNone)
+			, edgeDashId(DashIdNone)
 		{ }
 		std::string nodeLabel;
 		uint32_t nodeRadius;
@@ -50,6 +54,23 @@ public:
 		uint32_t edgeWidth;
 		std::string edgeDash;
 		uint32_t fontColor;
+		uint32_t colorMapValue; ///< The value mapped by FillColorMap and BorderColorMap, it is not drawn.
+
+		// Dash ids of borderDash and edgeDash, the units are got by getDash().
+		// They are decided by the strings, so they are not compared.
+		uint32_t borderDashId;
+		uint32_t edgeDashId;
+
+		auto tie() const
+		{
+			return std::tie(nodeLabel, nodeRadius, borderColor, borderWidth, borderDash,
+							fillColor, edgeColor, edgeWidth, edgeDash, fontColor, colorMapValue);
+		}
+
+		bool operator==(const NodeBaseProperty& other) const
+		{
+			return tie() == other.tie();
+		}
 	};
 
 	struct NodeProperty
@@ -72,6 +93,8 @@ public:
 				, pageBackgroundColor(PageBackgroundColorDefault)
 				, pageMarginXIncrement(PageMarginXIncrementDefault)
 				, pageMarginYIncrement(PageMarginYIncrementDefault)
+				, colorMapMin(ColorMapMinDefault)
+				, colorMapMax(ColorMapMaxDefault)
 			{ }
 			std::string fontFamily;
 			uint32_t fontSize;
@@ -83,13 +106,41 @@ public:
 			uint32_t pageBackgroundColor;
 			uint32_t pageMarginXIncrement;
 			uint32_t pageMarginYIncrement;
+			std::string fillColorMap;
+			std::string borderColorMap;
+			uint32_t colorMapMin;
+			uint32_t colorMapMax;
+
+			auto tie() const
+			{
+				return std::tie(fontFamily, fontSize, fontSlant, fontWeight, radiusIncrement,
+								edgeXIncrement, edgeYIncrement, pageBackgroundColor,
+								pageMarginXIncrement, pageMarginYIncrement,
+								fillColorMap, borderColorMap, colorMapMin, colorMapMax);
+			}
+
+			bool operator==(const NodeExtendProperty& other) const
+			{
+				return tie() == other.tie();
+			}
 		} nodeExtendProperty;
-	};
 
-	typedef bool (*CheckValueFn)(const std::string& inputValue, std::any& outputValue);
-	typedef void (*SendPropertyToNodeArrayFn)(const NodeInfo::element_t& element,
-											  NodeProperty& nodeProperty);
+		bool operator==(const NodeProperty& other) const
+		{
+			return nodeBaseProperty == other.nodeBaseProperty &&
+				   nodeExtendProperty == other.nodeExtendProperty;
+		}
+
+		/**
+		 * @brief Hash of all the property values, equal NodeProperty have the same hash.
+		 */
+		std::size_t hash() const;
+	};
 
+	/**
+	 * @brief Schema of one property, all of them are in the constexpr propertyTable.
+	 * The value type and scope are decided by the member of NodeProperty which holds the value.
+	 */
 	struct PropertyRecord
 	{
 		enum class ElementValueType
@@ -98,13 +149,112 @@ public:
 			String
 		};
 
-		uint32_t elementIndexOrId;
-		std::string propertyName;
+		using NodeExtendProperty = NodeProperty::NodeExtendProperty;
+
+		uint32_t elementIndexOrId; 		///< Property-index of propertyTable.
+		std::string_view propertyName;
 		ElementValueType valueType;
 		bool isExtendProperty;
-		mutable bool isPropertyGlobalOverrided;
-		BiTreePropertyManager::CheckValueFn checkValue;
-		BiTreePropertyManager::SendPropertyToNodeArrayFn sender;
+		uint32_t valueMin; 				///< Min value of Uint32, or min length of String.
+		uint32_t valueMax; 				///< Max value of Uint32, or max length of String.
+		bool (*isStringValid)(std::string_view); ///< Optional checker of a String value's format.
+
+		// Only one of them is not nullptr, it is the member holding the value.
+		uint32_t NodeBaseProperty::*baseUint32;
+		std::string NodeBaseProperty::*baseString;
+		uint32_t NodeExtendProperty::*extendUint32;
+		std::string NodeExtendProperty::*extendString;
+		uint32_t NodeBaseProperty::*baseDashId; ///< Dash id member of a dash String member.
+
+		constexpr PropertyRecord()
+			: PropertyRecord({}, ElementValueType::Uint32, false, 0, 0)
+		{ }
+
+		constexpr PropertyRecord(std::string_view name,
+								 uint32_t min,
+								 uint32_t max,
+								 uint32_t NodeBaseProperty::*member)
+			: PropertyRecord(name, ElementValueType::Uint32, false, min, max)
+		{
+			baseUint32 = member;
+		}
+
+		constexpr PropertyRecord(std::string_view name,
+								 uint32_t min,
+								 uint32_t max,
+								 std::string NodeBaseProperty::*member)
+			: PropertyRecord(name, ElementValueType::String, false, min, max)
+		{
+			baseString = member;
+		}
+
+		constexpr PropertyRecord(std::string_view name,
+								 uint32_t min,
+								 uint32_t max,
+								 std::string NodeBaseProperty::*member,
+								 uint32_t NodeBaseProperty::*dashIdMember)
+			: PropertyRecord(name, ElementValueType::String, false, min, max)
+		{
+			baseString = member;
+			baseDashId = dashIdMember;
+		}
+
+		constexpr PropertyRecord(std::string_view name,
+								 uint32_t min,
+								 uint32_t max,
+								 uint32_t NodeExtendProperty::*member)
+			: PropertyRecord(name, ElementValueType::Uint32, true, min, max)
+		{
+			extendUint32 = member;
+		}
+
+		constexpr PropertyRecord(std::string_view name,
+								 uint32_t min,
+								 uint32_t max,
+								 std::string NodeExtendProperty::*member,
+								 bool (*checker)(std::string_view) = nullptr)
+			: PropertyRecord(name, ElementValueType::String, true, min, max)
+		{
+			extendString = member;
+			isStringValid = checker;
+		}
+
+		/**
+		 * @brief Check a value string by the value type and range, without exception.
+		 * 
+		 * @param inputValue 	Input value string, a Uint32 is decimal, hex after "0x" or octal after "0".
+		 * @param outputValue 	Output typed value if it is valid, a dash string is parsed to its dash id.
+		 * @return true 		Valid.
+		 * @return false 		Invalid.
+		 */
+		bool checkValue(const std::string& inputValue, PropertyValue& outputValue) const;
+
+		/**
+		 * @brief Typed setters, set the value to its member of nodeProperty.
+		 */
+		void setNumber(NodeProperty& nodeProperty, const uint32_t& number) const;
+		void setString(NodeProperty& nodeProperty, std::string_view string, const uint32_t& dashId = DashIdNone) const;
+		void setValue(NodeProperty& nodeProperty, const PropertyValue& value) const;
+
+	private:
+		constexpr PropertyRecord(std::string_view name,
+								 ElementValueType type,
+								 bool isExtend,
+								 uint32_t min,
+								 uint32_t max)
+			: elementIndexOrId(UINT32_MAX)
+			, propertyName(name)
+			, valueType(type)
+			, isExtendProperty(isExtend)
+			, valueMin(min)
+			, valueMax(max)
+			, isStringValid(nullptr)
+			, baseUint32(nullptr)
+			, baseString(nullptr)
+			, extendUint32(nullptr)
+			, extendString(nullptr)
+			, baseDashId(nullptr)
+		{ }
 	};
 
 public:
@@ -117,24 +267,45 @@ public:
 	 * @param value 			The value to mapping to the NodeProperty.
 	 * @return NodeProperty 	Mapped NodeProperty. 
 	 */
-	static bool setCurrentProperty(const PropertyRecord& propertyRecord,
-								   const std::any& value,
-								   bool globalOverride = false);
+	bool setCurrentProperty(const PropertyRecord& propertyRecord,
+							const PropertyValue& value,
+							bool globalOverride = false);
 
 	/**
-	 * @brief Mapping input nodeInfo to mCurrentNodeProperty and return it.
+	 * @brief Mapping input value to mCurrentNodeProperty by its elementIndex.
 	 * 
-	 * @param nodeInfo 			The NodeInfo to mapping to the NodeProperty.
+	 * @param elementIndex 		Property-index of propertyTable.
+	 * @param value 			The value to mapping to the NodeProperty.
+	 * @param globalOverride 	Mapping to the global NodeProperty too.
+	 */
+	bool setCurrentProperty(const uint32_t& elementIndex,
+							const PropertyValue& value,
+							bool globalOverride = false);
+
+	/**
+	 * @brief Reset all the current properties to default, it should be called before a new bitree is parsed.
+	 */
+	void reset();
+
+	/**
+	 * @brief Mapping input nodeInfo then the node's inline nodeInfo to mCurrentNodeProperty and return it.
+	 * The inline properties are more specific, so they are mapped last.
+	 * 
+	 * @param nodeInfoArray 	The NodeInfoArray holding the String values of the NodeInfo.
+	 * @param nodeInfo 			The NodeInfo matched by NodeId, it can be nullptr.
+	 * @param inlineNodeInfo 	The NodeInfo attached to the node, it can be nullptr.
 	 * @return NodeProperty 	Mapped NodeProperty. 
 	 */
-	static const NodeProperty& getCurrentPropertyByUpdate(const NodeInfo& nodeInfo);
+	const NodeProperty& getCurrentPropertyByUpdate(const NodeInfoArray& nodeInfoArray,
+												   const NodeInfo* nodeInfo,
+												   const NodeInfo* inlineNodeInfo);
 
 	/**
 	 * @brief Get default NodeProperty
 	 * 
 	 * @return NodeProperty		Default NodeProperty
 	 */
-	static const NodeProperty& getCurrentProperty();
+	const NodeProperty& getCurrentProperty() const;
 
 	/**
 	 * @brief Check node id.
@@ -176,7 +347,7 @@ public:
 	 */
 	static bool isPropertyValueValid(const PropertyRecord& inputPropertyRecord,
 									 const std::string& valueString,
-									 std::any& valueOutput);
+									 PropertyValue& valueOutput);
 	/**
 	 * @brief Get the Element value type by elementIndex.
 	 * Usually the elementIndex mapping to propertyTable-index.
@@ -197,17 +368,33 @@ public:
 	static bool getPropertyRecordBy(const std::string& prpoertyNameStr,
 									PropertyRecord& propertyRecord);
 
-private:
-	static const std::vector<PropertyRecord> propertyTable;
-	static const std::size_t propertyTableSize;
+	/**
+	 * @brief Parse a dash string of BorderDash or EdgeDash to its dash units.
+	 * 
+	 * @param dashStr 		Input dash string, such as "4 2", the units are separated by spaces or ",;:|".
+	 * @param dashArray 	Output dash units, it is empty if the string is empty or invalid.
+	 * @return true 		Valid, there are 2 units at least in [1, 255] before the first invalid unit or the end.
+	 * @return false 		Invalid.
+	 */
+	static bool parseDash(std::string_view dashStr, std::vector<double>& dashArray);
 
-	static NodeProperty mCurrentNodeProperty;
-	static NodeProperty mCurrentNodePropertyOverride;
+	/**
+	 * @brief Parse a dash string once and keep its units in the dash pool, the same string gets the same id.
+	 * 
+	 * @param dashStr 		Input dash string.
+	 * @return uint32_t 	Dash id, DashIdNone if the string is invalid.
+	 */
+	static uint32_t internDash(std::string_view dashStr);
 
-	static uint32_t getNextId()
-	{
-		static uint32_t i = 0;
-		return i++;
-	};
+	/**
+	 * @brief Get the dash units of a dash id, they are empty for DashIdNone.
+	 * The returned reference keeps valid while the process runs.
+	 */
+	static const std::vector<double>& getDash(const uint32_t& dashId);
+
+private:
+	// The current properties belong to one document, so every document has its own BiTreePropertyManager.
+	NodeProperty mCurrentNodeProperty;
+	NodeProperty mCurrentNodePropertyOverride;
 }; // BiTreePropertyManager-define-end
 } // namespace bitree
@@ -31,25 +31,40 @@ public:
 	~BiTreeRenderer();
 	/**
 	 * @brief Rendering a bitree.
+	 * It is rendered to a png by tiles in parallel if the outputFile ends with [.png],
+	 * or written to a svg as a stream if it ends with [.svg], or a pdf otherwise.
 	 * 
-	 * @param nodeInfoArray 	Input node info array.
-	 * @param layoutInfo 		Input layout info.
+	 * @param layoutInfo 		Input layout info, with the resolved node properties.
 	 * @param outputFile 		Input output file name.
 	 * @return true 			Rendering pass.
 	 * @return false 			Rendering not pass.
 	 */
-	bool draw(const NodeInfoArray* nodeInfoArray,
-			  const BiTreeLayouter::LayoutInfo& layoutInfo,
+	bool draw(const BiTreeLayouter::LayoutInfo& layoutInfo,
 			  const std::string& outputFile);
+	/**
+	 * @brief Set the resolution of the png output.
+	 * 
+	 * @param dpi 				Input dots per inch, in [PngDpiMin, PngDpiMax].
+	 */
+	void setDpi(const uint32_t& dpi);
 	/**
 	 * @brief Get the best radius automatically for node rendering.
 	 * 
-	 * @param strLen 	Input the node's label's max length.
-	 * @return double 	Radius for node-rendering.
+	 * @param strLen 			Input the node's label's max length.
+	 * @param propertyManager 	Input the property context of the document, its font is used.
+	 * @return double 			Radius for node-rendering.
 	 */
-	static double getBestRadius(const std::size_t& strLen);
+	static double getBestRadius(const std::size_t& strLen,
+								const BiTreePropertyManager& propertyManager);
 
 private:
+	uint32_t mDpi = PngDpiDefault;
+
+	/**
+	 * @brief Write the bitree to a svg file node by node, the shared styles are css classes.
+	 */
+	bool drawSvg(const BiTreeLayouter::LayoutInfo& layoutInfo, const std::string& outputFile);
+
 	struct pos_t
 	{
 		double x;
@@ -77,10 +92,6 @@ private:
 
 	double getDistance(const pos_t& p1, const pos_t& p2);
 
-	bool convertDashStringToCairoDash(const std::string& nodeDashStr,
-									  std::vector<double>& dashes,
-									  double& offset);
-
 	//
 	// Color functions-----------------------------
 	//
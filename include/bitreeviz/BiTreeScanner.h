@@ -0,0 +1,138 @@
+/*
+The MIT License
+
+Copyright 2021 Krishna sssky307@163.com
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#pragma once
+
+#include "BiTreeDefines.h"
+#include "BiTreeParser.h"
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace bitree
+{
+/**
+ * @brief Scan bitree text char by char and check its grammar without building any BiTreeNode.
+ * It only keeps one state for each open "(", so the memory is O(depth) of the bitree.
+ */
+class BiTreeScanner
+{
+public:
+	/**
+	 * @brief Receive the nodes found by the scanner.
+	 */
+	class Listener
+	{
+	public:
+		/**
+		 * @brief Which child of its parent the node is.
+		 */
+		enum class NodeSide : uint8_t
+		{
+			Root,
+			Left,
+			Right
+		};
+
+	public:
+		virtual ~Listener() { }
+
+		/**
+		 * @brief A node is found.
+		 * 
+		 * @param label 	Node's label.
+		 * @param depth 	Node's depth, the root's depth is 0.
+		 * @param side 		Which child of its parent the node is.
+		 */
+		virtual void onNodeBegin(std::string_view /*label*/, uint32_t /*depth*/, NodeSide /*side*/) { }
+
+		/**
+		 * @brief The node and all its children are scanned.
+		 * 
+		 * @param depth 	Node's depth, the root's depth is 0.
+		 */
+		virtual void onNodeEnd(uint32_t /*depth*/) { }
+	};
+
+public:
+	BiTreeScanner(Listener* listener = nullptr);
+
+	/**
+	 * @brief Scan next char of the bitree text.
+	 * 
+	 * @param ch 		Input char.
+	 * @return true 	Scan pass.
+	 * @return false 	Grammar error, the scanner stops working.
+	 */
+	bool put(const char& ch);
+
+	/**
+	 * @brief Tell the scanner the bitree text ends.
+	 * 
+	 * @return true 	The bitree is complete.
+	 * @return false 	The bitree is not complete.
+	 */
+	bool end();
+
+	/**
+	 * @brief Check the inline properties, such as 1{FillColor=0xff0000ff}, with the property parser.
+	 * The inline properties are skipped if it is not set.
+	 * 
+	 * @param propertyParser 	A check-only property parser, or nullptr.
+	 */
+	void setPropertyParser(BiTreeParser::BiTreePropertyParser* propertyParser);
+
+	/**
+	 * @brief Check if the scanner is inside "{...}" of inline properties.
+	 */
+	bool isInProperty() const;
+
+private:
+	enum class State : uint8_t
+	{
+		ExpectLeft, 	// After "(".
+		ExpectComma, 	// After the left child.
+		ExpectRight, 	// After ",".
+		ExpectRp 		// After the right child.
+	};
+
+	enum class TokenName
+	{
+		Id,
+		Lp,
+		Rp,
+		Comma,
+		End
+	};
+
+	Listener* mListener = nullptr;
+	std::vector<State> mStateStack; // One state for each open "(".
+	std::string mLabel; 			// Current label, its size is limited by NodeDataStrLenMax.
+	bool mIsNodePending = false; 	// A node is found, but not know if it has children.
+	bool mHasProperty = false; 		// The pending node has inline properties.
+	bool mIsInProperty = false; 	// Inside "{...}".
+	bool mIsInQuote = false; 		// Inside a quoted value of "{...}".
+	std::string mPropertyText; 		// Current inline properties, from "{" to "}".
+	BiTreeParser::BiTreePropertyParser* mPropertyParser = nullptr;
+	bool mIsRootFound = false;
+	bool mIsGood = true;
+	uint64_t mPosition = 0;
+
+	bool onToken(TokenName name);
+	void onChildDone();
+	bool onPropertyEnd();
+	bool error(const char* message);
+}; // BiTreeScanner-define-end
+} // namespace bitree
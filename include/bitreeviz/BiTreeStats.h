@@ -0,0 +1,62 @@
+/*
+The MIT License
+
+Copyright 2021 Krishna sssky307@163.com
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#pragma once
+
+#include "BiTreeScanner.h"
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace bitree
+{
+/**
+ * @brief Collect the statistics of a bitree from BiTreeScanner, without building any BiTreeNode.
+ * Except the per-level widths, it only keeps one frame for each open node, the memory is O(depth).
+ */
+class BiTreeStats : public BiTreeScanner::Listener
+{
+public:
+	uint64_t nodeCount = 0;
+	uint64_t leafCount = 0;					///< Nodes without any child, "1(,)" is a leaf too.
+	uint32_t height = 0;					///< Levels of the bitree, a single root is 1.
+	uint32_t maxLabelSize = 0;
+	int64_t balanceFactor = 0;				///< Root's left subtree height - right subtree height.
+	uint64_t maxAbsBalanceFactor = 0;		///< Max |balance factor| of all nodes.
+	std::vector<uint64_t> levelWidthArray; 	///< Node count of each level, root level first.
+
+	void onNodeBegin(std::string_view label, uint32_t depth, NodeSide side) override;
+	void onNodeEnd(uint32_t depth) override;
+
+	/**
+	 * @brief Format the statistics to a one-line JSON object.
+	 * 
+	 * @param inputFile 	Input file name, it is written to the "file" field.
+	 * @return std::string 	JSON text.
+	 */
+	std::string toJson(const std::string& inputFile) const;
+
+private:
+	struct Frame
+	{
+		uint32_t leftHeight = 0;
+		uint32_t rightHeight = 0;
+		NodeSide side = NodeSide::Root;
+		bool hasChild = false;
+	};
+
+	std::vector<Frame> mFrameStack; // One frame for each open node.
+}; // BiTreeStats-define-end
+} // namespace bitree
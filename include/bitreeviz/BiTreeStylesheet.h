@@ -0,0 +1,102 @@
+/*
+The MIT License
+
+Copyright 2021 Krishna sssky307@163.com
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#pragma once
+
+#include "BiTreeDefines.h"
+#include "BiTreeParser.h"
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace bitree
+{
+/**
+ * @brief A stylesheet is a file of property lines, it is included by [@include "file"] in a bitree file.
+ * Each stylesheet is parsed to checked and typed records only once, then it is cached for the whole process,
+ * so the files sharing it in a batch only pay for applying the records.
+ * The cache is shared by all documents, it can be used by the documents parsed in different threads.
+ */
+class BiTreeStylesheet
+{
+public:
+	using Record = BiTreeParser::BiTreePropertyParser::Record;
+
+	/**
+	 * @brief Check if a line is an include line, other lines starting with "@" are selector lines.
+	 * 
+	 * @param begin 	Begin of a trimmed line.
+	 * @param end 		End of a trimmed line.
+	 */
+	static bool isIncludeLine(str_ptr_t begin, str_ptr_t end);
+
+	/**
+	 * @brief Get the file of an include line: @include "file", the quotes are optional.
+	 * 
+	 * @param begin 	Begin of a trimmed line, it should be "@".
+	 * @param end 		End of a trimmed line.
+	 * @param status 	Store result, true if it is a valid include line.
+	 * @param file 		Store the included file.
+	 * @return str_ptr_t 	Position after the include line.
+	 */
+	static str_ptr_t getIncludeFile(str_ptr_t begin, str_ptr_t end, bool& status, std::string& file);
+
+	/**
+	 * @brief An included file is relative to the directory of the including file.
+	 * 
+	 * @param includingFile 	The file has the include line.
+	 * @param file 				The included file.
+	 * @return std::string 		Resolved file name.
+	 */
+	static std::string resolvePath(const std::string& includingFile, const std::string& file);
+
+	/**
+	 * @brief Get a stylesheet from the cache, it is parsed if not cached or the file is modified.
+	 * 
+	 * @param file 		Stylesheet file name, it should be resolved by resolvePath().
+	 * @return std::shared_ptr<const BiTreeStylesheet> 	The stylesheet, nullptr if the file cannot be read or has error(s).
+	 */
+	static std::shared_ptr<const BiTreeStylesheet> load(const std::string& file);
+
+	/**
+	 * @brief Remove all cached stylesheets.
+	 */
+	static void clearCache();
+
+	const std::vector<Record>& getRecordArray() const;
+
+private:
+	struct FileStamp
+	{
+		std::string file;
+		int64_t time = 0; 	// Last write time.
+		uint64_t size = 0;
+	};
+
+	std::vector<Record> mRecordArray; 		// Records of this file and all its included files.
+	std::vector<FileStamp> mFileStampArray; // This file and all its included files when they are parsed.
+	bool mIsGood = false;
+	bool mIsLoading = false; 				// Used to find include cycle.
+
+	static std::map<std::string, std::shared_ptr<BiTreeStylesheet>> mCache;
+	static std::recursive_mutex mCacheMutex;
+
+	static bool getFileStamp(const std::string& file, FileStamp& fileStamp);
+	bool isModified() const;
+	bool parsing(const std::string& file);
+}; // BiTreeStylesheet-define-end
+} // namespace bitree
@@ -12,7 +12,10 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 
 #pragma once
 
+#include "BiTreeDefines.h"
+
 #include <string>
+#include <vector>
 
 namespace bitree
 {
@@ -42,6 +45,42 @@ public:
 	 * @return false 	Operations have error(s).
 	 */
 	bool run();
+
+	/**
+	 * @brief Set the resolution of the png output, it is used by run() when the output file is a [.png].
+	 * 
+	 * @param dpi 		Input dots per inch, in [PngDpiMin, PngDpiMax].
+	 */
+	void setDpi(const uint32_t& dpi);
+
+	/**
+	 * @brief Only check the grammar and property lines of the input files, nothing is rendered.
+	 * 
+	 * @param inputFiles 	Input file names.
+	 * @return true 		All files pass.
+	 * @return false 		Some files have error(s).
+	 */
+	static bool check(const std::vector<std::string>& inputFiles);
+
+	/**
+	 * @brief Print the statistics of the input files as JSON, one line for each file, nothing is rendered.
+	 * 
+	 * @param inputFiles 	Input file names.
+	 * @return true 		All files pass.
+	 * @return false 		Some files have error(s).
+	 */
+	static bool stats(const std::vector<std::string>& inputFiles);
+
+	/**
+	 * @brief Render each input file to [inputFile].pdf in one process.
+	 * The included stylesheets are parsed only once for all the files.
+	 * 
+	 * @param inputFiles 	Input file names.
+	 * @return true 		All files pass.
+	 * @return false 		Some files have error(s).
+	 */
+	static bool batch(const std::vector<std::string>& inputFiles);
+
 	static const std::string& getNameAndVersion();
 	static void ShowHelp();
 	static void ShowVersion();
@@ -49,6 +88,7 @@ public:
 private:
 	std::string mInputFile;
 	std::string mOutputfile;
+	uint32_t mDpi = PngDpiDefault;
 	BiTreeRenderer* mRenderer = nullptr;
 	BiTreeFileParser* mFileParser = nullptr;
 
@@ -58,6 +98,6 @@ private:
 	 * @param fileName 		Input file name string.
 	 * @return std::string 	Converted file name string.
 	 */
-	std::string convertSlash(std::string fileName);
+	static std::string convertSlash(std::string fileName);
 };
 } // namespace bitree
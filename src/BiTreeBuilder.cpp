@@ -0,0 +1,429 @@
+/*
+The MIT License
+
+Copyright 2021 Krishna sssky307@163.com
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include "bitreeviz/BiTreeBuilder.h"
+#include "bitreeviz/BiTreeDefines.h"
+#include "bitreeviz/BiTreePropertyManager.h"
+#include "bitreeviz/BiTreeRenderer.h"
+
+#include <stack>
+
+using namespace bitree;
+
+BiTreeBuilder::BiTreeBuilder()
+{
+	BiTreeAssert(mNodeInfoArray == nullptr);
+	mNodeInfoArray = new NodeInfoArray;
+	BiTreeAssert(mNodeInfoArray != nullptr);
+
+	BiTreeAssert(mPropertyManager == nullptr);
+	mPropertyManager = new BiTreePropertyManager;
+	BiTreeAssert(mPropertyManager != nullptr);
+
+	BiTreeAssert(mLabelPool == nullptr);
+	mLabelPool = new LabelPool;
+	BiTreeAssert(mLabelPool != nullptr);
+}
+
+BiTreeBuilder::~BiTreeBuilder()
+{
+	clear();
+	if(mNodeInfoArray)
+	{
+		delete mNodeInfoArray;
+		mNodeInfoArray = nullptr;
+	}
+	if(mPropertyManager)
+	{
+		delete mPropertyManager;
+		mPropertyManager = nullptr;
+	}
+	if(mLabelPool)
+	{
+		delete mLabelPool;
+		mLabelPool = nullptr;
+	}
+}
+
+void BiTreeBuilder::clear()
+{
+	for(auto& node : mNodeArray)
+	{
+		delete node;
+		node = nullptr;
+	}
+	mNodeArray.clear();
+
+	BiTreeAssert(mNodeInfoArray != nullptr);
+	mNodeInfoArray->clearInlineNodeInfo();
+
+	if(mBiTreeLayouter)
+	{
+		delete mBiTreeLayouter;
+		mBiTreeLayouter = nullptr;
+	}
+}
+
+bool BiTreeBuilder::isNodeHandleValid(NodeHandle node) const
+{
+	return node < mNodeArray.size();
+}
+
+bool BiTreeBuilder::isLabelValid(const std::string& label) const
+{
+	if(label.empty() || label.size() > NodeDataStrLenMax)
+	{
+		PrintError("Invalid node label size: %zu, it should be in [1, %u].\n",
+				   label.size(),
+				   NodeDataStrLenMax);
+		return false;
+	}
+
+	return true;
+}
+
+bool BiTreeBuilder::isAncestor(const BiTreeParser::BiTreeNode* node,
+							   const BiTreeParser::BiTreeNode* child) const
+{
+	// From the node to its root.
+	while(node != nullptr)
+	{
+		if(node == child)
+		{
+			return true;
+		}
+		node = node->parent;
+	}
+
+	return false;
+}
+
+BiTreeBuilder::NodeHandle BiTreeBuilder::createNode(const std::string& label)
+{
+	if(!isLabelValid(label) || mNodeArray.size() >= NodeHandleInvalid)
+	{
+		return NodeHandleInvalid;
+	}
+
+	auto node = new BiTreeParser::BiTreeNode(mLabelPool->intern(label));
+	BiTreeAssert(node != nullptr);
+	mNodeArray.push_back(node);
+
+	return (NodeHandle)(mNodeArray.size() - 1);
+}
+
+bool BiTreeBuilder::setChildren(NodeHandle node, NodeHandle leftChild, NodeHandle rightChild)
+{
+	if(!isNodeHandleValid(node))
+	{
+		PrintError("Invalid node handle: %u.\n", node);
+		return false;
+	}
+
+	auto parent = mNodeArray[node];
+	auto checkChild = [&](NodeHandle child) {
+		if(child == NodeHandleInvalid)
+		{
+			return true;
+		}
+		if(!isNodeHandleValid(child))
+		{
+			PrintError("Invalid child handle: %u.\n", child);
+			return false;
+		}
+
+		auto n = mNodeArray[child];
+		if(n->parent != nullptr && n->parent != parent)
+		{
+			PrintError("Node %u already has a parent.\n", child);
+			return false;
+		}
+		if(isAncestor(parent, n))
+		{
+			PrintError("Node %u is an ancestor of node %u, it cannot be a child.\n", child, node);
+			return false;
+		}
+
+		return true;
+	};
+
+	if(!checkChild(leftChild) || !checkChild(rightChild) ||
+	   (leftChild != NodeHandleInvalid && leftChild == rightChild))
+	{
+		return false;
+	}
+
+	// Detach old children.
+	if(parent->leftChild)
+	{
+		parent->leftChild->parent = nullptr;
+	}
+	if(parent->rightChild)
+	{
+		parent->rightChild->parent = nullptr;
+	}
+
+	parent->leftChild = (leftChild == NodeHandleInvalid ? nullptr : mNodeArray[leftChild]);
+	parent->rightChild = (rightChild == NodeHandleInvalid ? nullptr : mNodeArray[rightChild]);
+
+	if(parent->leftChild)
+	{
+		parent->leftChild->parent = parent;
+	}
+	if(parent->rightChild)
+	{
+		parent->rightChild->parent = parent;
+	}
+
+	return true;
+}
+
+bool BiTreeBuilder::setLabel(NodeHandle node, const std::string& label)
+{
+	if(!isNodeHandleValid(node))
+	{
+		PrintError("Invalid node handle: %u.\n", node);
+		return false;
+	}
+	if(!isLabelValid(label))
+	{
+		return false;
+	}
+
+	mNodeArray[node]->labelId = mLabelPool->intern(label);
+
+	return true;
+}
+
+bool BiTreeBuilder::setNodeProperty(NodeHandle node,
+									const std::string& propertyName,
+									const std::string& propertyValue)
+{
+	if(!isNodeHandleValid(node))
+	{
+		PrintError("Invalid node handle: %u.\n", node);
+		return false;
+	}
+
+	BiTreePropertyManager::PropertyRecord propertyRecord;
+	if(!BiTreePropertyManager::isPropertyNameValid(propertyName, propertyRecord))
+	{
+		PrintError("Invalid property name: [%s]\n", propertyName.c_str());
+		return false;
+	}
+	if(propertyRecord.isExtendProperty)
+	{
+		PrintError("Extend property: [%s] cannot be used as node property.\n",
+				   propertyName.c_str());
+		return false;
+	}
+
+	PropertyValue value;
+	if(!BiTreePropertyManager::isPropertyValueValid(propertyRecord, propertyValue, value))
+	{
+		PrintError("Property-value is invalid: [%s = %s].\n",
+				   propertyName.c_str(),
+				   propertyValue.c_str());
+		return false;
+	}
+
+	// Attach the property to the node directly, the same as the inline property in the bitree.
+	auto n = mNodeArray[node];
+	if(n->nodeInfo == nullptr)
+	{
+		BiTreeAssert(mNodeInfoArray != nullptr);
+		n->nodeInfo = mNodeInfoArray->addInlineNodeInfo(NodeInfo());
+	}
+
+	mNodeInfoArray->setValue(
+		*const_cast<NodeInfo*>(n->nodeInfo), propertyRecord.elementIndexOrId, value);
+
+	return true;
+}
+
+bool BiTreeBuilder::setGlobalProperty(const std::string& propertyName,
+									  const std::string& propertyValue)
+{
+	BiTreePropertyManager::PropertyRecord propertyRecord;
+	if(!BiTreePropertyManager::isPropertyNameValid(propertyName, propertyRecord))
+	{
+		PrintError("Invalid property name: [%s]\n", propertyName.c_str());
+		return false;
+	}
+
+	PropertyValue value;
+	if(!BiTreePropertyManager::isPropertyValueValid(propertyRecord, propertyValue, value))
+	{
+		PrintError("Property-value is invalid: [%s = %s].\n",
+				   propertyName.c_str(),
+				   propertyValue.c_str());
+		return false;
+	}
+
+	BiTreeAssert(mPropertyManager != nullptr);
+	return mPropertyManager->setCurrentProperty(propertyRecord, value, true);
+}
+
+bool BiTreeBuilder::buildFromArrays(const std::vector<std::string>& labels,
+									const std::vector<NodeHandle>& leftChildren,
+									const std::vector<NodeHandle>& rightChildren)
+{
+	clear();
+
+	if(labels.size() != leftChildren.size() || labels.size() != rightChildren.size())
+	{
+		PrintError("Array size not match, labels: %zu, leftChildren: %zu, rightChildren: %zu.\n",
+				   labels.size(),
+				   leftChildren.size(),
+				   rightChildren.size());
+		return false;
+	}
+
+	mNodeArray.reserve(labels.size());
+	for(auto const& label : labels)
+	{
+		if(createNode(label) == NodeHandleInvalid)
+		{
+			clear();
+			return false;
+		}
+	}
+
+	for(NodeHandle i = 0; i < (NodeHandle)labels.size(); i++)
+	{
+		if(!setChildren(i, leftChildren[i], rightChildren[i]))
+		{
+			clear();
+			return false;
+		}
+	}
+
+	return true;
+}
+
+bool BiTreeBuilder::buildFromLevelOrder(const std::vector<std::string>& labels,
+										const std::string& emptyLabel)
+{
+	const std::size_t size = labels.size();
+	std::vector<NodeHandle> leftChildren(size, NodeHandleInvalid);
+	std::vector<NodeHandle> rightChildren(size, NodeHandleInvalid);
+
+	auto getChild = [&](std::size_t parent, std::size_t child) {
+		if(child < size && labels[parent] != emptyLabel && labels[child] != emptyLabel)
+		{
+			return (NodeHandle)child;
+		}
+		return NodeHandleInvalid;
+	};
+
+	for(std::size_t i = 0; i < size; i++)
+	{
+		leftChildren[i] = getChild(i, 2 * i + 1);
+		rightChildren[i] = getChild(i, 2 * i + 2);
+	}
+
+	if(!size || labels.front() == emptyLabel)
+	{
+		PrintError("The root of level-order array is empty.\n");
+		clear();
+		return false;
+	}
+
+	// Empty nodes are created too but never linked, so node i keeps handle i.
+	std::vector<std::string> nodeLabels(labels);
+	for(auto& label : nodeLabels)
+	{
+		if(label == emptyLabel)
+		{
+			label = "_";
+		}
+	}
+
+	return buildFromArrays(nodeLabels, leftChildren, rightChildren);
+}
+
+bool BiTreeBuilder::layout(NodeHandle root)
+{
+	if(!isNodeHandleValid(root))
+	{
+		PrintError("Invalid root handle: %u.\n", root);
+		return false;
+	}
+
+	auto rootNode = mNodeArray[root];
+	if(rootNode->parent != nullptr)
+	{
+		PrintError("Node %u has a parent, it cannot be the root.\n", root);
+		return false;
+	}
+
+	// Reset the runtime generated properties, get max label size at the same time.
+	std::size_t maxLabelSize = 0;
+	std::stack<BiTreeParser::BiTreeNode*> stack;
+	stack.push(rootNode);
+	while(!stack.empty())
+	{
+		auto n = stack.top();
+		stack.pop();
+
+		n->x = n->y = n->subTreeOffsetX = 0.0f;
+		auto labelSize = mLabelPool->get(n->labelId).size();
+		if(maxLabelSize < labelSize)
+		{
+			maxLabelSize = labelSize;
+		}
+
+		if(n->leftChild)
+			stack.push(n->leftChild);
+		if(n->rightChild)
+			stack.push(n->rightChild);
+	}
+
+	if(mBiTreeLayouter)
+	{
+		delete mBiTreeLayouter;
+		mBiTreeLayouter = nullptr;
+	}
+
+	PrintInfo("Layouting bitree..........................\n");
+	mBiTreeLayouter = new BiTreeLayouter(
+		BiTreeRenderer::getBestRadius(maxLabelSize, *mPropertyManager), mPropertyManager);
+	BiTreeAssert(mBiTreeLayouter != nullptr);
+
+	if(!mBiTreeLayouter->layout(rootNode, mLabelPool, mNodeInfoArray))
+	{
+		PrintInfo("Layouting bitree...........................failed\n");
+		return false;
+	}
+
+	PrintInfo("Layouting bitree..........................ok\n");
+	return true;
+}
+
+const NodeInfoArray* BiTreeBuilder::getNodeInfoArray() const
+{
+	BiTreeAssert(mNodeInfoArray != nullptr);
+	return mNodeInfoArray;
+}
+
+const LabelPool* BiTreeBuilder::getLabelPool() const
+{
+	BiTreeAssert(mLabelPool != nullptr);
+	return mLabelPool;
+}
+
+const BiTreeLayouter::LayoutInfo& BiTreeBuilder::getLayoutInfo()
+{
+	BiTreeAssert(mBiTreeLayouter != nullptr);
+	return *(mBiTreeLayouter->getLayoutInfoConst());
+}
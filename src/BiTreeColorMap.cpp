@@ -0,0 +1,136 @@
+/*
+The MIT License
+
+Copyright 2021 Krishna sssky307@163.com
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include "bitreeviz/BiTreeColorMap.h"
+
+#include <algorithm>
+#include <charconv>
+
+using namespace bitree;
+
+namespace
+{
+struct Gradient
+{
+	std::string_view name;
+	std::array<uint32_t, BiTreeColorMap::StopCountMax> stopArray;
+	uint32_t stopCount;
+};
+
+// Built-in gradients, the stops are evenly spaced.
+constexpr Gradient builtinGradientArray[] = {
+	{"gray", {0x000000ff, 0xffffffff}, 2},
+	{"heat", {0x000000ff, 0xff0000ff, 0xffff00ff, 0xffffffff}, 4},
+	{"viridis", {0x440154ff, 0x3b528bff, 0x21918cff, 0x5ec962ff, 0xfde725ff}, 5},
+	{"coolwarm", {0x3b4cc0ff, 0xddddddff, 0xb40426ff}, 3}};
+
+// Parse a built-in name or the colors separated by spaces.
+bool parseGradient(std::string_view gradient, Gradient& output)
+{
+	for(auto const& builtin : builtinGradientArray)
+	{
+		if(builtin.name == gradient)
+		{
+			output = builtin;
+			return true;
+		}
+	}
+
+	output.stopCount = 0;
+	auto begin = gradient.data();
+	auto end = gradient.data() + gradient.size();
+	while(true)
+	{
+		while(begin < end && *begin == ' ')
+			++begin;
+		if(begin == end)
+		{
+			break;
+		}
+		if(output.stopCount == BiTreeColorMap::StopCountMax || end - begin < 3 || begin[0] != '0' ||
+		   (begin[1] != 'x' && begin[1] != 'X'))
+		{
+			return false;
+		}
+
+		uint32_t color = 0;
+		auto result = std::from_chars(begin + 2, end, color, 16);
+		if(result.ec != std::errc() || (result.ptr < end && *result.ptr != ' '))
+		{
+			return false;
+		}
+		output.stopArray[output.stopCount++] = color;
+		begin = result.ptr;
+	}
+
+	return output.stopCount >= 2;
+}
+
+uint32_t mixChannel(uint32_t color0, uint32_t color1, uint32_t shift, double weight)
+{
+	auto c0 = (double)((color0 >> shift) & 0xff);
+	auto c1 = (double)((color1 >> shift) & 0xff);
+
+	return (uint32_t)(c0 + (c1 - c0) * weight + 0.5) << shift;
+}
+} // namespace
+
+bool BiTreeColorMap::isGradientValid(std::string_view gradient)
+{
+	Gradient output;
+	return parseGradient(gradient, output);
+}
+
+bool BiTreeColorMap::load(std::string_view gradient)
+{
+	Gradient output;
+	if(!parseGradient(gradient, output))
+	{
+		return false;
+	}
+
+	// Sample the gradient, every channel is interpolated between its two nearest stops.
+	auto segmentCount = output.stopCount - 1;
+	for(uint32_t i = 0; i < TableSize; i++)
+	{
+		auto position = (double)i / (TableSize - 1) * segmentCount;
+		auto segment = std::min((uint32_t)position, segmentCount - 1);
+		auto weight = position - segment;
+		auto color0 = output.stopArray[segment];
+		auto color1 = output.stopArray[segment + 1];
+
+		mColorTable[i] = mixChannel(color0, color1, 24, weight) | mixChannel(color0, color1, 16, weight) |
+						 mixChannel(color0, color1, 8, weight) | mixChannel(color0, color1, 0, weight);
+	}
+
+	return true;
+}
+
+void BiTreeColorMap::map(const std::vector<double>& valueArray,
+						 double valueMin,
+						 double valueMax,
+						 std::vector<uint32_t>& colorArray) const
+{
+	// All the values are mapped to the first color if the range is empty.
+	auto scale = valueMax > valueMin ? (TableSize - 1) / (valueMax - valueMin) : 0.0;
+	auto count = valueArray.size();
+	colorArray.resize(count);
+
+	auto values = valueArray.data();
+	auto colors = colorArray.data();
+	for(std::size_t i = 0; i < count; i++)
+	{
+		auto position = std::clamp((values[i] - valueMin) * scale, 0.0, (double)(TableSize - 1));
+		colors[i] = mColorTable[(uint32_t)(position + 0.5)];
+	}
+}
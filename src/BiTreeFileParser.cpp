@@ -12,11 +12,16 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 
 #include "bitreeviz/BiTreeFileParser.h"
 #include "bitreeviz/BiTreeDefines.h"
+#include "bitreeviz/BiTreeInputStream.h"
 #include "bitreeviz/BiTreePropertyManager.h"
 #include "bitreeviz/BiTreeRenderer.h"
 
-#include <fstream>
-#include <sstream>
+#include <algorithm>
+#include <cctype>
+#include <deque>
+#include <future>
+#include <thread>
+#include <vector>
 
 using namespace bitree;
 
@@ -62,18 +67,17 @@ bool BiTreeFileParser::parsing()
 	}
 
 	PrintInfo("Open file: [%s]\n", mFileParserInfo.mInputFile.c_str());
-	std::ifstream inFile(mFileParserInfo.mInputFile);
-	if(!inFile.good())
+	BiTreeInputStream inFile(mFileParserInfo.mInputFile);
+	if(!inFile.open())
 	{
-		PrintError("Cannot open file:[%s]\n", mFileParserInfo.mInputFile.c_str());
 		return status;
 	}
 
 	auto propertyParser = biTreeParser->getPropertyParser();
 	BiTreeAssert(propertyParser!=nullptr);
 
-	// Read file line by line;
-	for(std::string line; std::getline(inFile, line);)
+	// Read file line by line, compressed file is decompressed chunk by chunk;
+	for(std::string line; inFile.getLine(line);)
 	{
 		str_ptr_t begin = line.begin();
 		str_ptr_t end = line.end();
@@ -115,17 +119,18 @@ bool BiTreeFileParser::parsing()
 		else
 		{
 			// Parsing properties----------------------------------
-			static size_t i = 0;
-			if(propertyParser->parsing(begin, end) != true)
-			{
-				status = false;
-				break;
-			}
+			status = parsingProperties(line, inFile, propertyParser);
+			break;
 		}
 	}
 
 	// Parsing properties done.
-	printf("\n");
+	fprintf(PrintStream(), "\n");
+
+	if(!inFile.good())
+	{
+		status = false;
+	}
 
 	if(status)
 	{
@@ -135,12 +140,12 @@ bool BiTreeFileParser::parsing()
 		BiTreeAssert(layouter == nullptr);
 		BiTreeAssert(mFileParserInfo.mBiTreeParser!=nullptr);
 		auto radius = BiTreeRenderer::getBestRadius(
-		mFileParserInfo.mBiTreeParser->getMaxTokenSizeCurrent());
-		layouter=new BiTreeLayouter(radius);
+		mFileParserInfo.mBiTreeParser->getMaxTokenSizeCurrent(), *propertyParser->getPropertyManager());
+		layouter=new BiTreeLayouter(radius, propertyParser->getPropertyManager());
 		BiTreeAssert(layouter != nullptr);
 
 		auto root = mFileParserInfo.mBiTreeParser->getRoot();
-		status = layouter->layout(root);
+		status = layouter->layout(root, mFileParserInfo.mBiTreeParser->getLabelPool(), getNodeInfoArray());
 		if(status)
 		{
 			PrintInfo("Layouting bitree..........................ok\n");
@@ -158,6 +163,214 @@ bool BiTreeFileParser::parsing()
 	return status;
 }
 
+bool BiTreeFileParser::parsingProperties(const std::string& firstLine,
+										 BiTreeInputStream& inFile,
+										 BiTreeParser::BiTreePropertyParser* propertyParser)
+{
+	using Record = BiTreeParser::BiTreePropertyParser::Record;
+
+	struct PropertyLine
+	{
+		std::string text; 		// The trimmed line, an include line is kept to the end of the line.
+		std::size_t size = 0; 	// Size of the trimmed line.
+	};
+
+	struct PropertyChunk
+	{
+		bool status = true;
+		std::vector<Record> recordArray;
+	};
+
+	// A chunk of lines parsed on a worker thread, or a line starting with "@" parsed on this thread.
+	struct PropertyItem
+	{
+		std::future<PropertyChunk> chunk;
+		PropertyLine line;
+	};
+
+	auto parsingLine = [this](const PropertyLine& line, BiTreeParser::BiTreePropertyParser* parser) {
+		auto begin = line.text.cbegin();
+		if(BiTreeStylesheet::isIncludeLine(begin, line.text.cend()))
+		{
+			return including(begin, line.text.cend(), parser);
+		}
+		return parser->parsing(begin, begin + line.size);
+	};
+
+	// Every chunk has its own parser, the records are applied in the order of the lines later,
+	// so the last property still takes effect.
+	auto parsingChunk = [printStream = PrintStream()](std::vector<PropertyLine> lineArray) {
+		PrintStream() = printStream;
+
+		PropertyChunk chunk;
+		BiTreeParser::BiTreePropertyParser parser;
+		parser.setRecordArray(&chunk.recordArray);
+		parser.setQuiet(true);
+		for(auto const& line : lineArray)
+		{
+			if(!parser.parsing(line.text.cbegin(), line.text.cbegin() + line.size))
+			{
+				PrintError("Invalid property line: [%s].\n", line.text.c_str());
+				chunk.status = false;
+				break;
+			}
+		}
+
+		return chunk;
+	};
+
+	std::vector<PropertyLine> lineArray; 	// Lines not sent to a worker thread yet.
+	std::deque<PropertyItem> itemArray; 	// Items not applied yet.
+	std::size_t chunkCount = 0; 			// Chunks in itemArray.
+	std::size_t lineCount = 0;
+	bool isParallel = false;
+	const std::size_t maxChunkCount = 2 * std::max(1u, std::thread::hardware_concurrency());
+
+	auto applyFrontItem = [&]() {
+		auto item = std::move(itemArray.front());
+		itemArray.pop_front();
+		if(!item.chunk.valid())
+		{
+			return parsingLine(item.line, propertyParser);
+		}
+
+		--chunkCount;
+		auto chunk = item.chunk.get();
+		return chunk.status && propertyParser->apply(chunk.recordArray);
+	};
+
+	auto sendChunk = [&]() {
+		if(!lineArray.empty())
+		{
+			itemArray.push_back({std::async(std::launch::async, parsingChunk, std::move(lineArray)), {}});
+			lineArray.clear();
+			++chunkCount;
+		}
+	};
+
+	auto addLine = [&](PropertyLine&& line) {
+		if(line.text.front() == '@')
+		{
+			sendChunk();
+			itemArray.push_back({std::future<PropertyChunk>(), std::move(line)});
+		}
+		else
+		{
+			lineArray.push_back(std::move(line));
+			if(lineArray.size() >= PropertyChunkLineCount)
+			{
+				sendChunk();
+			}
+		}
+
+		// The finished chunks are applied while the others are parsed, so the memory is bounded.
+		bool status = true;
+		while(status && chunkCount > maxChunkCount)
+		{
+			status = applyFrontItem();
+		}
+
+		return status;
+	};
+
+	bool status = true;
+	std::string line = firstLine;
+	do
+	{
+		str_ptr_t begin = line.begin();
+		str_ptr_t end = line.end();
+
+		begin = trimLine(begin, end);
+		if(begin >= end)
+			continue;
+
+		PropertyLine propertyLine;
+		propertyLine.text.assign(begin, *begin == '@' ? line.cend() : end);
+		propertyLine.size = end - begin;
+		++lineCount;
+
+		if(isParallel)
+		{
+			status = addLine(std::move(propertyLine));
+			continue;
+		}
+
+		lineArray.push_back(std::move(propertyLine));
+		if(lineArray.size() >= PropertyChunkLineCount)
+		{
+			// It is a long property section, so the lines are parsed on worker threads.
+			isParallel = true;
+			auto bufferedArray = std::move(lineArray);
+			lineArray.clear();
+			for(auto& bufferedLine : bufferedArray)
+			{
+				status = status && addLine(std::move(bufferedLine));
+			}
+		}
+	} while(status && inFile.getLine(line));
+
+	if(!isParallel)
+	{
+		for(auto const& propertyLine : lineArray)
+		{
+			if(!parsingLine(propertyLine, propertyParser))
+			{
+				return false;
+			}
+		}
+
+		return status;
+	}
+
+	if(status)
+	{
+		sendChunk();
+	}
+	while(status && !itemArray.empty())
+	{
+		status = applyFrontItem();
+	}
+
+	PrintInfo("Parsing %zu property lines on worker threads.........%s\n",
+			  lineCount,
+			  status ? "ok" : "failed");
+
+	return status;
+}
+
+bool BiTreeFileParser::including(str_ptr_t begin,
+								 str_ptr_t end,
+								 BiTreeParser::BiTreePropertyParser* propertyParser)
+{
+	bool status = false;
+	std::string file;
+
+	BiTreeStylesheet::getIncludeFile(begin, end, status, file);
+	if(!status)
+	{
+		PrintError("Invalid include line: [%s].\n", std::string(begin, end).c_str());
+		return false;
+	}
+
+	file = BiTreeStylesheet::resolvePath(mFileParserInfo.mInputFile, file);
+	auto stylesheet = BiTreeStylesheet::load(file);
+	if(stylesheet == nullptr)
+	{
+		return false;
+	}
+
+	if(propertyParser == nullptr)
+	{
+		return true;
+	}
+
+	PrintInfo("Include stylesheet: [%s], %zu properties.\n",
+			  file.c_str(),
+			  stylesheet->getRecordArray().size());
+
+	return propertyParser->apply(stylesheet->getRecordArray());
+}
+
 const NodeInfoArray* BiTreeFileParser::getNodeInfoArray()
 {
 	BiTreeAssert(mFileParserInfo.mBiTreeParser);
@@ -257,3 +470,156 @@ std::string::const_iterator BiTreeFileParser::trimStartToken(std::string::const_
 
 	return begin;
 }
+
+bool BiTreeFileParser::checking()
+{
+	BiTreeScanner scanner;
+	return scanning(scanner, true);
+}
+
+bool BiTreeFileParser::statistics(BiTreeStats& stats)
+{
+	BiTreeScanner scanner(&stats);
+	return scanning(scanner, false);
+}
+
+bool BiTreeFileParser::scanning(BiTreeScanner& scanner, bool isCheckingProperty)
+{
+	BiTreeInputStream inFile(mFileParserInfo.mInputFile);
+	if(!inFile.open())
+	{
+		return false;
+	}
+
+	std::size_t lineNumber = 1;
+	char ch = 0;
+	bool status = false;
+
+	auto skipLine = [&]() {
+		while(inFile.getChar(ch) && ch != '\n') { }
+	};
+
+	// 001, skip blank lines and note lines before the bitree.
+	while(inFile.getChar(ch))
+	{
+		if(ch == '\n')
+		{
+			++lineNumber;
+		}
+		else if(ch == '/' || ch == '#')
+		{
+			skipLine();
+			++lineNumber;
+		}
+		else if(ch > 0x20)
+		{
+			status = true;
+			break;
+		}
+	}
+
+	// 002, trim start token and "=", case-insensitive.
+	const std::string& startToken = mFileParserInfo.mStartToken;
+	for(std::size_t i = 0; status && i < startToken.size(); i++)
+	{
+		if(i > 0 && !inFile.getChar(ch))
+		{
+			status = false;
+		}
+		else if(std::toupper((unsigned char)ch) != std::toupper((unsigned char)startToken[i]))
+		{
+			status = false;
+		}
+	}
+	while(status && inFile.getChar(ch) && ch <= 0x20 && ch != '\n') { }
+	if(!status || ch != '=')
+	{
+		PrintError("Check file begin with [ %s = ] failed, at line %zu.\n",
+				   startToken.c_str(),
+				   lineNumber);
+		return false;
+	}
+
+	// Inline properties are checked with the same property parser as the property lines.
+	BiTreeParser::BiTreePropertyParser propertyParser;
+	propertyParser.setCheckOnly(true);
+	if(isCheckingProperty)
+	{
+		scanner.setPropertyParser(&propertyParser);
+	}
+
+	// 003, scan the bitree line.
+	// The same as trimLine(), spaces and [,;/] at the end of the line are ignored,
+	// so they are held back until a following char shows they are not at the end.
+	uint32_t heldCommaCount = 0;
+	char heldInvalidChar = 0;
+	bool isHoldingChar = false;
+	while(status && inFile.getChar(ch) && ch != '\n')
+	{
+		// Nothing is trimmed inside "{...}".
+		if(scanner.isInProperty())
+		{
+			status = scanner.put(ch);
+			continue;
+		}
+
+		if(ch <= 0x20 || ch == ',' || ch == ';' || ch == '/')
+		{
+			isHoldingChar = true;
+			if(ch == ',')
+			{
+				++heldCommaCount;
+			}
+			else if(ch > 0x20 && heldInvalidChar == 0)
+			{
+				heldInvalidChar = ch;
+			}
+			continue;
+		}
+
+		if(isHoldingChar)
+		{
+			status = (heldInvalidChar != 0 ? scanner.put(heldInvalidChar) : scanner.put(' '));
+			for(; status && heldCommaCount > 0; --heldCommaCount)
+			{
+				status = scanner.put(',');
+			}
+			isHoldingChar = false;
+			heldCommaCount = 0;
+			heldInvalidChar = 0;
+		}
+
+		status = status && scanner.put(ch);
+	}
+	status = status && scanner.end();
+
+	// 004, check property lines.
+	if(status && isCheckingProperty)
+	{
+		for(std::string line; status && inFile.getLine(line);)
+		{
+			++lineNumber;
+
+			str_ptr_t begin = line.begin();
+			str_ptr_t end = line.end();
+			begin = trimLine(begin, end);
+			if(begin >= end)
+				continue;
+
+			if(BiTreeStylesheet::isIncludeLine(begin, line.cend()))
+			{
+				status = including(begin, line.cend(), nullptr);
+				continue;
+			}
+
+			status = propertyParser.parsing(begin, end);
+		}
+	}
+
+	if(!status)
+	{
+		PrintError("Check failed at line %zu.\n", lineNumber);
+	}
+
+	return status && inFile.good();
+}
@@ -0,0 +1,356 @@
+/*
+The MIT License
+
+Copyright 2021 Krishna sssky307@163.com
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include "bitreeviz/BiTreeInputStream.h"
+#include "bitreeviz/BiTreeDefines.h"
+
+#include "config.h"
+
+#include <algorithm>
+#include <utility>
+
+#ifdef _WIN32
+#	include <fcntl.h>
+#	include <io.h>
+#endif
+
+#ifdef BITREEVIZ_HAVE_ZLIB
+#	include <zlib.h>
+#endif
+
+#ifdef BITREEVIZ_HAVE_ZSTD
+#	include <zstd.h>
+#endif
+
+using namespace bitree;
+
+BiTreeInputStream::BiTreeInputStream(const std::string& inputFile)
+	: mInputFile(inputFile)
+	, mInBuffer(ChunkSize)
+	, mOutBuffer(ChunkSize)
+{ }
+
+BiTreeInputStream::~BiTreeInputStream()
+{
+	close();
+}
+
+void BiTreeInputStream::close()
+{
+	if(mDecoder)
+	{
+#ifdef BITREEVIZ_HAVE_ZLIB
+		if(mCompression == Compression::Gzip)
+		{
+			inflateEnd((z_stream*)mDecoder);
+			delete(z_stream*)mDecoder;
+		}
+#endif
+#ifdef BITREEVIZ_HAVE_ZSTD
+		if(mCompression == Compression::Zstd)
+		{
+			ZSTD_freeDStream((ZSTD_DStream*)mDecoder);
+		}
+#endif
+		mDecoder = nullptr;
+	}
+
+	if(mFile)
+	{
+		if(mFile != stdin)
+		{
+			fclose(mFile);
+		}
+		mFile = nullptr;
+	}
+}
+
+bool BiTreeInputStream::open()
+{
+	close();
+	mIsGood = false;
+	mIsInputEnd = false;
+	mIsFrameEnd = true;
+	mInBegin = mInEnd = mOutBegin = mOutEnd = 0;
+
+	if(mInputFile == "-")
+	{
+		// Read from a pipe, it is streamed chunk by chunk too.
+#ifdef _WIN32
+		_setmode(_fileno(stdin), _O_BINARY);
+#endif
+		mFile = stdin;
+	}
+	else
+	{
+		mFile = fopen(mInputFile.c_str(), "rb");
+	}
+	if(mFile == nullptr)
+	{
+		PrintError("Cannot open file:[%s]\n", mInputFile.c_str());
+		return false;
+	}
+
+	mIsGood = true;
+	readChunk();
+	if(!mIsGood)
+	{
+		PrintError("Cannot read file:[%s]\n", mInputFile.c_str());
+		return false;
+	}
+
+	// Detect compression by magic bytes.
+	auto isMagic = [&](const std::vector<unsigned char>& magic) {
+		if(mInEnd - mInBegin < magic.size())
+		{
+			return false;
+		}
+		return std::equal(magic.begin(), magic.end(), (unsigned char*)(&mInBuffer[mInBegin]));
+	};
+
+	mCompression = Compression::None;
+	if(isMagic({0x1f, 0x8b}))
+	{
+		mCompression = Compression::Gzip;
+#ifdef BITREEVIZ_HAVE_ZLIB
+		auto stream = new z_stream();
+		BiTreeAssert(stream != nullptr);
+
+		// 15 + 32: max window size and auto detect gzip or zlib header.
+		if(inflateInit2(stream, 15 + 32) != Z_OK)
+		{
+			delete stream;
+			PrintError("Cannot init gzip decompressor.\n");
+			mIsGood = false;
+			return false;
+		}
+		mDecoder = stream;
+#else
+		PrintError("File [%s] is gzip compressed, but gzip is not supported by this build.\n",
+				   mInputFile.c_str());
+		mIsGood = false;
+		return false;
+#endif
+	}
+	else if(isMagic({0x28, 0xb5, 0x2f, 0xfd}))
+	{
+		mCompression = Compression::Zstd;
+#ifdef BITREEVIZ_HAVE_ZSTD
+		auto stream = ZSTD_createDStream();
+		if(stream == nullptr || ZSTD_isError(ZSTD_initDStream(stream)))
+		{
+			ZSTD_freeDStream(stream);
+			PrintError("Cannot init zstd decompressor.\n");
+			mIsGood = false;
+			return false;
+		}
+		mDecoder = stream;
+#else
+		PrintError("File [%s] is zstd compressed, but zstd is not supported by this build.\n",
+				   mInputFile.c_str());
+		mIsGood = false;
+		return false;
+#endif
+	}
+
+	return true;
+}
+
+bool BiTreeInputStream::good() const
+{
+	return mIsGood;
+}
+
+BiTreeInputStream::Compression BiTreeInputStream::getCompression() const
+{
+	return mCompression;
+}
+
+bool BiTreeInputStream::readChunk()
+{
+	mInBegin = mInEnd = 0;
+	if(mFile == nullptr || mIsInputEnd)
+	{
+		return false;
+	}
+
+	mInEnd = fread(mInBuffer.data(), 1, ChunkSize, mFile);
+	if(mInEnd < ChunkSize)
+	{
+		if(ferror(mFile))
+		{
+			PrintError("Read file failed:[%s]\n", mInputFile.c_str());
+			mIsGood = false;
+		}
+		mIsInputEnd = true;
+	}
+
+	return mInEnd > 0;
+}
+
+bool BiTreeInputStream::fill()
+{
+	mOutBegin = mOutEnd = 0;
+	if(!mIsGood)
+	{
+		return false;
+	}
+
+	switch(mCompression)
+	{
+	case Compression::Gzip:
+		return fillGzip();
+	case Compression::Zstd:
+		return fillZstd();
+	default:
+		// Not compressed, the raw chunk is the output.
+		if(mInBegin == mInEnd && !readChunk())
+		{
+			return false;
+		}
+		std::swap(mInBuffer, mOutBuffer);
+		mOutBegin = mInBegin;
+		mOutEnd = mInEnd;
+		mInBegin = mInEnd = 0;
+		return true;
+	}
+}
+
+bool BiTreeInputStream::fillGzip()
+{
+#ifdef BITREEVIZ_HAVE_ZLIB
+	auto stream = (z_stream*)mDecoder;
+	BiTreeAssert(stream != nullptr);
+
+	while(true)
+	{
+		if(mInBegin == mInEnd && !readChunk())
+		{
+			if(!mIsFrameEnd)
+			{
+				PrintError("Gzip file is truncated:[%s]\n", mInputFile.c_str());
+				mIsGood = false;
+			}
+			return false;
+		}
+
+		stream->next_in = (Bytef*)(&mInBuffer[mInBegin]);
+		stream->avail_in = (uInt)(mInEnd - mInBegin);
+		stream->next_out = (Bytef*)mOutBuffer.data();
+		stream->avail_out = (uInt)ChunkSize;
+
+		auto ret = inflate(stream, Z_NO_FLUSH);
+		mInBegin = mInEnd - stream->avail_in;
+		mOutEnd = ChunkSize - stream->avail_out;
+
+		if(ret == Z_STREAM_END)
+		{
+			// Maybe there are concatenated gzip members.
+			inflateReset(stream);
+			mIsFrameEnd = true;
+		}
+		else if(ret != Z_OK && ret != Z_BUF_ERROR)
+		{
+			PrintError("Gzip decompress failed:[%s], %s\n",
+					   mInputFile.c_str(),
+					   stream->msg ? stream->msg : "");
+			mIsGood = false;
+			return false;
+		}
+		else
+		{
+			mIsFrameEnd = false;
+		}
+
+		if(mOutEnd > 0)
+		{
+			return true;
+		}
+	}
+#else
+	return false;
+#endif
+}
+
+bool BiTreeInputStream::fillZstd()
+{
+#ifdef BITREEVIZ_HAVE_ZSTD
+	auto stream = (ZSTD_DStream*)mDecoder;
+	BiTreeAssert(stream != nullptr);
+
+	while(true)
+	{
+		if(mInBegin == mInEnd && !readChunk())
+		{
+			if(!mIsFrameEnd)
+			{
+				PrintError("Zstd file is truncated:[%s]\n", mInputFile.c_str());
+				mIsGood = false;
+			}
+			return false;
+		}
+
+		ZSTD_inBuffer input = {&mInBuffer[mInBegin], mInEnd - mInBegin, 0};
+		ZSTD_outBuffer output = {mOutBuffer.data(), ChunkSize, 0};
+
+		auto ret = ZSTD_decompressStream(stream, &output, &input);
+		if(ZSTD_isError(ret))
+		{
+			PrintError("Zstd decompress failed:[%s], %s\n",
+					   mInputFile.c_str(),
+					   ZSTD_getErrorName(ret));
+			mIsGood = false;
+			return false;
+		}
+
+		// Zero means a frame is complete.
+		mIsFrameEnd = (ret == 0);
+		mInBegin += input.pos;
+		mOutEnd = output.pos;
+
+		if(mOutEnd > 0)
+		{
+			return true;
+		}
+	}
+#else
+	return false;
+#endif
+}
+
+bool BiTreeInputStream::getLine(std::string& line)
+{
+	line.clear();
+	bool hasChar = false;
+
+	while(true)
+	{
+		if(mOutBegin == mOutEnd && !fill())
+		{
+			return hasChar;
+		}
+
+		hasChar = true;
+		auto begin = mOutBuffer.data() + mOutBegin;
+		auto end = mOutBuffer.data() + mOutEnd;
+		auto pos = std::find(begin, end, '\n');
+
+		line.append(begin, pos);
+		if(pos != end)
+		{
+			mOutBegin += (pos - begin) + 1;
+			return true;
+		}
+		mOutBegin = mOutEnd;
+	}
+}
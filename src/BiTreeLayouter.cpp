@@ -11,43 +11,48 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 */
 
 #include "bitreeviz/BiTreeLayouter.h"
+#include "bitreeviz/BiTreeColorMap.h"
 #include "bitreeviz/BiTreeDefines.h"
 #include "bitreeviz/BiTreePropertyManager.h"
 
+#include <algorithm>
 #include <cassert>
 #include <iostream>
 #include <limits>
 #include <stack>
+#include <unordered_map>
 #include <vector>
 
 using namespace bitree;
 
-BiTreeLayouter::BiTreeLayouter(const double& radius)
+BiTreeLayouter::BiTreeLayouter(const double& radius, BiTreePropertyManager* propertyManager)
+	: mPropertyManager(propertyManager)
 {
 	BiTreeAssert(radius > 1.0f);
+	BiTreeAssert(mPropertyManager != nullptr);
 	BiTreeAssert(mLayoutInfo == nullptr);
 	mLayoutInfo = new LayoutInfo();
 	BiTreeAssert(mLayoutInfo != nullptr);
 
 	mLayoutInfo->offset_h_ =
 		Sin30 * 2.1 * radius +
-		BiTreePropertyManager::getCurrentProperty().nodeExtendProperty.edgeXIncrement;
+		mPropertyManager->getCurrentProperty().nodeExtendProperty.edgeXIncrement;
 
 	mLayoutInfo->offset_v_ =
 		Sin60 * 2.1 * radius +
-		BiTreePropertyManager::getCurrentProperty().nodeExtendProperty.edgeYIncrement;
+		mPropertyManager->getCurrentProperty().nodeExtendProperty.edgeYIncrement;
 
 	auto baseValue = 5.0f + Sin30 * 2.5 * radius;
 	mLayoutInfo->pageMarginX =
 		baseValue +
-		BiTreePropertyManager::getCurrentProperty().nodeExtendProperty.pageMarginXIncrement;
+		mPropertyManager->getCurrentProperty().nodeExtendProperty.pageMarginXIncrement;
 	mLayoutInfo->pageMarginY =
 		baseValue +
-		BiTreePropertyManager::getCurrentProperty().nodeExtendProperty.pageMarginYIncrement;
+		mPropertyManager->getCurrentProperty().nodeExtendProperty.pageMarginYIncrement;
 	
 	// This radius is only used for drawing.
 	mLayoutInfo->raduis =
-		radius + BiTreePropertyManager::getCurrentProperty().nodeExtendProperty.radiusIncrement;	
+		radius + mPropertyManager->getCurrentProperty().nodeExtendProperty.radiusIncrement;	
 }
 
 BiTreeLayouter::~BiTreeLayouter()
@@ -342,13 +347,17 @@ void BiTreeLayouter::finalInitXYCoordinate(BiTreeParser::BiTreeNode* node)
 	}
 }
 
-bool BiTreeLayouter::layout(BiTreeParser::BiTreeNode* root)
+bool BiTreeLayouter::layout(BiTreeParser::BiTreeNode* root,
+							const LabelPool* labelPool,
+							const NodeInfoArray* nodeInfoArray)
 {
-	if(root)
+	if(root && labelPool && nodeInfoArray)
 	{
+		getLayoutInfo()->labelPool = labelPool;
 		firstInitYCoordinate(root);
 		SecondInitXCoordinate(root);
 		finalInitXYCoordinate(root);
+		resolveStyle(nodeInfoArray);
 
 		return true;
 	}
@@ -356,6 +365,266 @@ bool BiTreeLayouter::layout(BiTreeParser::BiTreeNode* root)
 	return false;
 }
 
+void BiTreeLayouter::resolveStyle(const NodeInfoArray* nodeInfoArray)
+{
+	auto layoutInfo = getLayoutInfo();
+	BiTreeAssert(layoutInfo->labelPool != nullptr);
+	auto const& labelPool = *layoutInfo->labelPool;
+
+	// Matching NodeInfo once for each distinct label, nodes with the same label share the result.
+	// Nothing to match if all the node properties are inline.
+	std::vector<const NodeInfo*> labelNodeInfoArray(labelPool.size(), nullptr);
+	std::vector<const NodeInfo*> labelInheritedNodeInfoArray; // The same as labelNodeInfoArray, for @inherit lines.
+	bool isInherited = nodeInfoArray->hasInheritedNodeInfo();
+	if(isInherited)
+	{
+		labelInheritedNodeInfoArray.assign(labelPool.size(), nullptr);
+	}
+	for(uint32_t labelId = 0; !nodeInfoArray->empty() && labelId < labelPool.size(); labelId++)
+	{
+		auto nodeId = labelPool.getNodeId(labelId);
+		if(nodeId != NodeIdInvalid)
+		{
+			labelNodeInfoArray[labelId] = nodeInfoArray->findNodeInfo(nodeId);
+			if(isInherited)
+			{
+				labelInheritedNodeInfoArray[labelId] = nodeInfoArray->findNodeInfo(nodeId, true);
+			}
+		}
+		else
+		{
+			labelNodeInfoArray[labelId] = nodeInfoArray->findNodeInfo(labelPool.get(labelId));
+			if(isInherited)
+			{
+				labelInheritedNodeInfoArray[labelId] = nodeInfoArray->findNodeInfo(labelPool.get(labelId), true);
+			}
+		}
+	}
+
+	// Equal NodeProperty are interned to one style, so the renderer sets up each style only once.
+	// Nodes without any NodeInfo use the global properties, styleArray[0].
+	std::unordered_multimap<std::size_t, uint32_t> styleIndexMap; // Hash of a NodeProperty to its style index.
+	layoutInfo->styleArray.clear();
+
+	auto internStyle = [&](const BiTreePropertyManager::NodeProperty& nodeProperty) {
+		auto hash = nodeProperty.hash();
+		auto range = styleIndexMap.equal_range(hash);
+		for(auto it = range.first; it != range.second; ++it)
+		{
+			if(layoutInfo->styleArray[it->second] == nodeProperty)
+			{
+				return it->second;
+			}
+		}
+
+		auto styleIndex = (uint32_t)layoutInfo->styleArray.size();
+		layoutInfo->styleArray.push_back(nodeProperty);
+		styleIndexMap.emplace(hash, styleIndex);
+
+		return styleIndex;
+	};
+	internStyle(mPropertyManager->getCurrentProperty());
+
+	// Nodes with the same label share the style resolved from the same NodeInfo.
+	std::vector<uint32_t> labelStyleIndexArray(labelPool.size(), UINT32_MAX);
+
+	// Selectors match nodes by their position and inherited properties flow from the ancestors,
+	// so the nodes are visited from root in pre-order, it is the reverse of bitreeNodeArray,
+	// then the ancestors of a node are always in ancestorArray, it is one pass without recursion.
+	auto const& selectorArray = nodeInfoArray->getSelectorArray();
+	bool isTopDown = (!selectorArray.empty() || isInherited);
+	std::vector<const BiTreeParser::BiTreeNode*> ancestorArray;
+	std::vector<NodeInfo> inheritedArray; // Inherited NodeInfo of each node of ancestorArray.
+	std::vector<uint32_t> subtreeDepthArray(selectorArray.size(), UINT32_MAX); // Depth of the visiting subtree root.
+
+	auto const& bitreeNodeArray = layoutInfo->bitreeNodeArray;
+	layoutInfo->nodeStyleArray.assign(bitreeNodeArray.size(), 0);
+
+	for(auto i = bitreeNodeArray.size(); i-- > 0;)
+	{
+		auto const& node = bitreeNodeArray[i];
+		BiTreeAssert(node->labelId < labelNodeInfoArray.size());
+		auto nodeInfo = labelNodeInfoArray[node->labelId];
+		uint32_t styleIndex = 0;
+
+		// Merge the inherited properties, then the properties of all the matched selectors,
+		// the later selector takes effect.
+		NodeInfo selectedNodeInfo;
+		if(isTopDown)
+		{
+			while(!ancestorArray.empty() && ancestorArray.back() != node->parent)
+			{
+				ancestorArray.pop_back();
+				if(isInherited)
+				{
+					inheritedArray.pop_back();
+				}
+			}
+			auto depth = (uint32_t)ancestorArray.size();
+			ancestorArray.push_back(node);
+
+			if(isInherited)
+			{
+				// A node inherits from its parent, its own @inherit properties override them.
+				inheritedArray.push_back(inheritedArray.empty() ? NodeInfo() : inheritedArray.back());
+				auto inheritedNodeInfo = labelInheritedNodeInfoArray[node->labelId];
+				if(inheritedNodeInfo != nullptr)
+				{
+					inheritedArray.back().merge(*inheritedNodeInfo);
+				}
+				selectedNodeInfo = inheritedArray.back();
+			}
+
+			auto nodeId = labelPool.getNodeId(node->labelId);
+			bool isLeaf = (node->leftChild == nullptr && node->rightChild == nullptr);
+
+			for(std::size_t k = 0; k < selectorArray.size(); k++)
+			{
+				auto const& selector = selectorArray[k];
+				bool isMatched = false;
+				switch(selector.type)
+				{
+				case NodeSelector::Type::Range:
+					isMatched = (nodeId != NodeIdInvalid && selector.first <= nodeId && nodeId <= selector.last);
+					break;
+				case NodeSelector::Type::Depth:
+					isMatched = (selector.first <= depth && depth <= selector.last);
+					break;
+				case NodeSelector::Type::Leaf:
+					isMatched = isLeaf;
+					break;
+				case NodeSelector::Type::Internal:
+					isMatched = !isLeaf;
+					break;
+				case NodeSelector::Type::Subtree:
+				{
+					// A subtree ends at the first node not deeper than its root.
+					auto& subtreeDepth = subtreeDepthArray[k];
+					if(subtreeDepth != UINT32_MAX && subtreeDepth >= depth)
+					{
+						subtreeDepth = UINT32_MAX;
+					}
+					if(subtreeDepth == UINT32_MAX && nodeId == selector.first)
+					{
+						subtreeDepth = depth;
+					}
+					isMatched = (subtreeDepth != UINT32_MAX);
+					break;
+				}
+				}
+
+				if(isMatched)
+				{
+					selectedNodeInfo.merge(selector.nodeInfo);
+				}
+			}
+		}
+
+		// Convert NodeInfo and the inline NodeInfo to its data-structure of properties.
+		if(!selectedNodeInfo.empty())
+		{
+			// The NodeId and inline properties are more specific than the selectors and the inherited ones.
+			for(auto const& info : {nodeInfo, node->nodeInfo})
+			{
+				if(info != nullptr)
+				{
+					selectedNodeInfo.merge(*info);
+				}
+			}
+			styleIndex = internStyle(mPropertyManager->getCurrentPropertyByUpdate(
+				*nodeInfoArray, &selectedNodeInfo, nullptr));
+		}
+		else if(node->nodeInfo != nullptr)
+		{
+			styleIndex = internStyle(mPropertyManager->getCurrentPropertyByUpdate(
+				*nodeInfoArray, nodeInfo, node->nodeInfo));
+		}
+		else if(nodeInfo != nullptr)
+		{
+			auto& labelStyleIndex = labelStyleIndexArray[node->labelId];
+			if(labelStyleIndex == UINT32_MAX)
+			{
+				labelStyleIndex = internStyle(mPropertyManager->getCurrentPropertyByUpdate(
+					*nodeInfoArray, nodeInfo, nullptr));
+			}
+			styleIndex = labelStyleIndex;
+		}
+
+		layoutInfo->nodeStyleArray[i] = styleIndex;
+	}
+
+	// Map the node values to colors, so a heatmap needs no property line for each node.
+	auto const& globalProperty = mPropertyManager->getCurrentProperty().nodeExtendProperty;
+	BiTreeColorMap fillColorMap;
+	BiTreeColorMap borderColorMap;
+	bool isFillMapped = !globalProperty.fillColorMap.empty() && fillColorMap.load(globalProperty.fillColorMap);
+	bool isBorderMapped = !globalProperty.borderColorMap.empty() && borderColorMap.load(globalProperty.borderColorMap);
+	if(!isFillMapped && !isBorderMapped)
+	{
+		return;
+	}
+
+	// Gather the values first, then all of them are mapped in one loop.
+	// A node without ColorMapValue and numeric label keeps its colors.
+	std::vector<uint32_t> mappedNodeArray; // Index of bitreeNodeArray of each value.
+	std::vector<double> valueArray;
+	for(std::size_t i = 0; i < bitreeNodeArray.size(); i++)
+	{
+		auto value = layoutInfo->styleArray[layoutInfo->nodeStyleArray[i]].nodeBaseProperty.colorMapValue;
+		bool hasValue = (value != ColorMapValueDefault);
+		if(!hasValue)
+		{
+			value = labelPool.getNodeId(bitreeNodeArray[i]->labelId);
+			hasValue = (value != NodeIdInvalid);
+		}
+		if(hasValue)
+		{
+			mappedNodeArray.push_back((uint32_t)i);
+			valueArray.push_back((double)value);
+		}
+	}
+	if(valueArray.empty())
+	{
+		return;
+	}
+
+	// Only the bound not set is taken from the values.
+	auto range = std::minmax_element(valueArray.begin(), valueArray.end());
+	double valueMin = globalProperty.colorMapMin != ColorMapMinDefault ? globalProperty.colorMapMin : *range.first;
+	double valueMax = globalProperty.colorMapMax != ColorMapMaxDefault ? globalProperty.colorMapMax : *range.second;
+
+	// Nodes with the same style and mapped color share the new style.
+	auto applyColor = [&](const BiTreeColorMap& colorMap, uint32_t BiTreePropertyManager::NodeBaseProperty::*member) {
+		std::vector<uint32_t> colorArray;
+		colorMap.map(valueArray, valueMin, valueMax, colorArray);
+
+		std::unordered_map<uint64_t, uint32_t> mappedStyleIndexMap; // Style index and color to the new style index.
+		for(std::size_t k = 0; k < mappedNodeArray.size(); k++)
+		{
+			auto& styleIndex = layoutInfo->nodeStyleArray[mappedNodeArray[k]];
+			auto key = ((uint64_t)styleIndex << 32) | colorArray[k];
+			auto result = mappedStyleIndexMap.emplace(key, 0);
+			if(result.second)
+			{
+				auto nodeProperty = layoutInfo->styleArray[styleIndex];
+				nodeProperty.nodeBaseProperty.*member = colorArray[k];
+				nodeProperty.nodeBaseProperty.colorMapValue = ColorMapValueDefault;
+				result.first->second = internStyle(nodeProperty);
+			}
+			styleIndex = result.first->second;
+		}
+	};
+
+	if(isFillMapped)
+	{
+		applyColor(fillColorMap, &BiTreePropertyManager::NodeBaseProperty::fillColor);
+	}
+	if(isBorderMapped)
+	{
+		applyColor(borderColorMap, &BiTreePropertyManager::NodeBaseProperty::borderColor);
+	}
+}
+
 double BiTreeLayouter::offsetH()
 {
 	BiTreeAssert(mLayoutInfo != nullptr);
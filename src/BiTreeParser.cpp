@@ -13,13 +13,16 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 #include "bitreeviz/BiTreeParser.h"
 #include "bitreeviz/BiTreePropertyManager.h"
 
+#include <algorithm>
 #include <iostream>
 #include <stack>
+#include <string_view>
 
 using namespace bitree;
 
-const std::size_t BiTreeParser::maxTokenSizeAllowed = 256;
-std::size_t BiTreeParser::maxTokenSizeCurrent = 0;
+const std::size_t BiTreeParser::maxTokenSizeAllowed = NodeDataStrLenMax;
+
+static constexpr std::string_view InheritDirective = "@inherit";
 
 bool BiTreeParser::BiTreePropertyParser::is_char_09(const char& ch)
 {
@@ -85,7 +88,8 @@ BiTreeParser::BiTreePropertyParser::getNodeId(str_ptr_t begin, str_ptr_t end, bo
 	begin = trimFrontSpace(begin, end);
 	while(begin < end)
 	{
-		if(is_char_09(*begin))
+		// The same chars as a label in the bitree.
+		if(is_char_az_AZ_09(*begin) || *begin == '_')
 		{
 			nodeId.push_back(*begin);
 			++begin;
@@ -107,6 +111,92 @@ BiTreeParser::BiTreePropertyParser::getNodeId(str_ptr_t begin, str_ptr_t end, bo
 	return begin;
 }
 
+bool BiTreeParser::BiTreePropertyParser::isInheritLine(str_ptr_t begin, str_ptr_t end)
+{
+	if(end - begin <= (std::ptrdiff_t)InheritDirective.size() ||
+	   !std::equal(InheritDirective.begin(), InheritDirective.end(), begin))
+	{
+		return false;
+	}
+
+	return *(begin + InheritDirective.size()) <= 0x20;
+}
+
+str_ptr_t BiTreeParser::BiTreePropertyParser::getSelector(str_ptr_t begin,
+														 str_ptr_t end,
+														 bool& status,
+														 NodeSelector& selector,
+														 std::string& selectorStr)
+{
+	static const std::pair<std::string_view, NodeSelector::Type> selectorNameArray[] = {
+		{"@range", NodeSelector::Type::Range},
+		{"@depth", NodeSelector::Type::Depth},
+		{"@leaf", NodeSelector::Type::Leaf},
+		{"@internal", NodeSelector::Type::Internal},
+		{"@subtree", NodeSelector::Type::Subtree}};
+
+	status = false;
+	selectorStr.clear();
+
+	// Get selector name, such as @depth.
+	auto nameEnd = begin + 1;
+	while(nameEnd < end && is_char_az_AZ(*nameEnd))
+		++nameEnd;
+	selectorStr.assign(begin, nameEnd);
+
+	auto it = std::find_if(std::begin(selectorNameArray),
+						   std::end(selectorNameArray),
+						   [&selectorStr](auto const& name) { return name.first == selectorStr; });
+	if(it == std::end(selectorNameArray))
+	{
+		return begin;
+	}
+	selector.type = it->second;
+
+	// Get the arguments before "[", such as 1000-50000 or 0x10.
+	begin = trimFrontSpace(nameEnd, end);
+	auto argEnd = begin;
+	while(argEnd < end && *argEnd != '[')
+		++argEnd;
+
+	auto toNumber = [](str_ptr_t first, str_ptr_t last, uint32_t& number) {
+		while(first < last && *first <= 0x20)
+			++first;
+		while(last > first && *(last - 1) <= 0x20)
+			--last;
+		return BiTreePropertyManager::isNodeIdValid(std::string(first, last), number);
+	};
+
+	auto argStr = std::string(begin, argEnd);
+	selectorStr += " " + argStr;
+	switch(selector.type)
+	{
+	case NodeSelector::Type::Leaf:
+	case NodeSelector::Type::Internal:
+		status = (trimFrontSpace(begin, argEnd) == argEnd);
+		break;
+	case NodeSelector::Type::Subtree:
+		status = toNumber(begin, argEnd, selector.first);
+		selector.last = selector.first;
+		break;
+	case NodeSelector::Type::Range:
+	case NodeSelector::Type::Depth:
+	{
+		// The last one is optional, such as @depth 3.
+		auto separator = std::find(begin, argEnd, '-');
+		status = toNumber(begin, separator, selector.first);
+		selector.last = selector.first;
+		if(status && separator != argEnd)
+		{
+			status = toNumber(separator + 1, argEnd, selector.last) && selector.first <= selector.last;
+		}
+		break;
+	}
+	}
+
+	return argEnd;
+}
+
 str_ptr_t BiTreeParser::BiTreePropertyParser::getPropertyName(str_ptr_t begin,
 												str_ptr_t end,
 												bool& status,
@@ -222,7 +312,7 @@ BiTreeParser::BiTreePropertyParser::getValueString(str_ptr_t begin,
 	}
 	else if(begin<end) // Token start with a visible char except ["].
 	{
-		while(begin<end &&*begin > 0x20 && *begin!=',' && *begin!=']' && *begin!='"' )
+		while(begin<end &&*begin > 0x20 && *begin!=',' && *begin!=mValueEndChar && *begin!='"' )
 		{
 				value.push_back(*begin);
 				++begin;
@@ -315,44 +405,81 @@ const NodeInfoArray* BiTreeParser::BiTreePropertyParser::getNodeInfoArray()const
 	return mNodeInfoArray;
 }
 
+BiTreePropertyManager* BiTreeParser::BiTreePropertyParser::getPropertyManager()
+{
+	BiTreeAssert(mPropertyManager != nullptr);
+	return mPropertyManager;
+}
+
 
 bool BiTreeParser::BiTreePropertyParser::parsing(str_ptr_t begin, str_ptr_t end)
 {
 	bool status = false;
 	std::string currentNodeIdStr;
-	uint32_t currentNodeId;
+	uint32_t currentNodeId = NodeIdInvalid;
 	bool isExtendPropertyCurrent=false;
 	
-	// 001, get node id.
-	begin = getNodeId(begin, end, status, currentNodeIdStr);
-	if(status==false)
+	NodeSelector selector;
+	bool isSelectorCurrent=false;
+	bool isInheritedCurrent=false;
+
+	// 001, get node id, or the selector of a selector line.
+	begin = trimFrontSpace(begin, end);
+	if(isInheritLine(begin, end))
+	{
+		// It is: @inherit nodeId[key = value, ...], the properties are inherited by the descendants.
+		begin = trimFrontSpace(begin + InheritDirective.size(), end);
+		isInheritedCurrent=true;
+	}
+
+	if(!isInheritedCurrent && begin < end && *begin == '@')
 	{
-		if(begin < end && *begin == '[')
+		begin = getSelector(begin, end, status, selector, currentNodeIdStr);
+		if(status==false)
 		{
-			isExtendPropertyCurrent=true;
+			PrintError("Invalid selector: [%s].\n", currentNodeIdStr.c_str());
+			return false;
 		}
-		else
+		if(mRecordArray)
 		{
-			PrintError("Invalid node id string: [%s].\n", currentNodeIdStr.c_str());
+			PrintError("Selector: [%s] cannot be used in a stylesheet.\n", currentNodeIdStr.c_str());
 			return false;
 		}
+		isSelectorCurrent=true;
 	}
 	else
 	{
-		if(!BiTreePropertyManager::isNodeIdValid(currentNodeIdStr,currentNodeId))
+		begin = getNodeId(begin, end, status, currentNodeIdStr);
+		if(status==false)
 		{
-			PrintError("Invalid node id: [%s].\n",currentNodeIdStr.c_str());
-			return false;
+			if(begin < end && *begin == '[' && !isInheritedCurrent)
+			{
+				isExtendPropertyCurrent=true;
+			}
+			else
+			{
+				PrintError("Invalid node id string: [%s].\n", currentNodeIdStr.c_str());
+				return false;
+			}
+		}
+		else if(!BiTreePropertyManager::isNodeIdValid(currentNodeIdStr,currentNodeId))
+		{
+			// It is a string NodeId, such as abc, only the node with the same label matches it.
+			currentNodeId=NodeIdInvalid;
 		}
 	}
 
-	if(isExtendPropertyCurrent)
+	if(mIsCheckOnly || mIsQuiet)
+	{
+		// Nothing is printed.
+	}
+	else if(isExtendPropertyCurrent)
 	{
 		PrintInfo("Parsing property: [");
 	}
 	else
 	{
-		PrintInfo("Parsing property: %s[",currentNodeIdStr.c_str());
+		PrintInfo("Parsing property: %s%s[", isInheritedCurrent ? "@inherit " : "", currentNodeIdStr.c_str());
 	}
 
 	begin = trimLpSquare(begin, end, status);
@@ -377,13 +504,17 @@ bool BiTreeParser::BiTreePropertyParser::parsing(str_ptr_t begin, str_ptr_t end)
 				return false;
 			}
 
-			if(isFirstKeyAndValue)
+			if(mIsCheckOnly || mIsQuiet)
 			{
-				printf("%s ", propertyName.c_str());
+				// Nothing is printed.
+			}
+			else if(isFirstKeyAndValue)
+			{
+				fprintf(PrintStream(), "%s ", propertyName.c_str());
 			}
 			else
 			{
-				printf("; %s ", propertyName.c_str());
+				fprintf(PrintStream(), "; %s ", propertyName.c_str());
 			}
 			
 			if(!BiTreePropertyManager::isPropertyNameValid(propertyName,propertyRecord))
@@ -426,8 +557,11 @@ bool BiTreeParser::BiTreePropertyParser::parsing(str_ptr_t begin, str_ptr_t end)
 				return false;
 			}
 
-			printf("= %s",propertyValue.c_str());
-			std::any value;
+			if(!mIsCheckOnly && !mIsQuiet)
+			{
+				fprintf(PrintStream(), "= %s",propertyValue.c_str());
+			}
+			PropertyValue value;
 			if(!BiTreePropertyManager::isPropertyValueValid(propertyRecord,propertyValue,value))
 			{
 				PrintError("Property-value is invalid.\n");
@@ -436,18 +570,39 @@ bool BiTreeParser::BiTreePropertyParser::parsing(str_ptr_t begin, str_ptr_t end)
 
 			// Save PropertyName(this is an elementIndex in PropertyManager.propertyTable);
 			// Save propertyValue;
-			if(isExtendPropertyCurrent)
+			if(mIsCheckOnly)
+			{
+				// Nothing is saved.
+			}
+			else if(mRecordArray)
+			{
+				mRecordArray->push_back({isExtendPropertyCurrent ? NodeIdInvalid : currentNodeId,
+										 propertyRecord.elementIndexOrId,
+										 value,
+										 currentNodeId == NodeIdInvalid ? currentNodeIdStr : std::string(),
+										 isInheritedCurrent});
+			}
+			else if(isExtendPropertyCurrent)
+			{
+				BiTreeAssert(mPropertyManager != nullptr);
+				mPropertyManager->setCurrentProperty(propertyRecord,value,true);
+			}
+			else if(isSelectorCurrent)
 			{
-				BiTreePropertyManager::setCurrentProperty(propertyRecord,value,true);
+				BiTreeAssert(mNodeInfoArray != nullptr);
+				mNodeInfoArray->setValue(selector.nodeInfo, propertyRecord.elementIndexOrId, value);
 			}
 			else
 			{
 				// Finally insert [propertyKey = propertyValue] here.
 				BiTreeAssert(mNodeInfoArray != nullptr);
-				status=mNodeInfoArray->insertNodeInfo(currentNodeId, propertyRecord.elementIndexOrId,value);
-				if(status==false)
+				if(currentNodeId == NodeIdInvalid)
 				{
-					PrintError("Insert to mNodeInfoArray failed.\n");
+					mNodeInfoArray->insertNodeInfo(std::string_view(currentNodeIdStr), propertyRecord.elementIndexOrId, value, isInheritedCurrent);
+				}
+				else
+				{
+					mNodeInfoArray->insertNodeInfo(currentNodeId, propertyRecord.elementIndexOrId, value, isInheritedCurrent);
 				}
 			}
 
@@ -484,27 +639,177 @@ bool BiTreeParser::BiTreePropertyParser::parsing(str_ptr_t begin, str_ptr_t end)
 		}
 	}
 
-	printf("]\n");
+	if(mIsCheckOnly)
+	{
+		return true;
+	}
+
+	if(isSelectorCurrent)
+	{
+		BiTreeAssert(mNodeInfoArray != nullptr);
+		mNodeInfoArray->addSelector(std::move(selector));
+	}
+
+	if(!mIsQuiet)
+	{
+		fprintf(PrintStream(), "]\n");
+	}
 
 	for(auto const& log:tempLog)
 	{
-		printf("%s",log.c_str());
+		fprintf(PrintStream(), "%s",log.c_str());
 	}
 
 	return true;
 }
 
+void BiTreeParser::BiTreePropertyParser::setCheckOnly(bool isCheckOnly)
+{
+	mIsCheckOnly = isCheckOnly;
+}
+
+void BiTreeParser::BiTreePropertyParser::setQuiet(bool isQuiet)
+{
+	mIsQuiet = isQuiet;
+}
+
+void BiTreeParser::BiTreePropertyParser::setRecordArray(std::vector<Record>* recordArray)
+{
+	mRecordArray = recordArray;
+}
+
+bool BiTreeParser::BiTreePropertyParser::apply(const std::vector<Record>& recordArray)
+{
+	for(auto const& record : recordArray)
+	{
+		if(!record.nodeLabel.empty())
+		{
+			BiTreeAssert(mNodeInfoArray != nullptr);
+			mNodeInfoArray->insertNodeInfo(std::string_view(record.nodeLabel), record.elementIndex, record.value, record.isInherited);
+		}
+		else if(record.nodeId == NodeIdInvalid)
+		{
+			BiTreeAssert(mPropertyManager != nullptr);
+			mPropertyManager->setCurrentProperty(record.elementIndex, record.value, true);
+		}
+		else
+		{
+			BiTreeAssert(mNodeInfoArray != nullptr);
+			mNodeInfoArray->insertNodeInfo(record.nodeId, record.elementIndex, record.value, record.isInherited);
+		}
+	}
+
+	return true;
+}
+
+str_ptr_t BiTreeParser::BiTreePropertyParser::parsingInline(str_ptr_t begin,
+															str_ptr_t end,
+															bool& status,
+															const NodeInfo*& nodeInfo)
+{
+	NodeInfo inlineNodeInfo;
+	status = false;
+	nodeInfo = nullptr;
+
+	BiTreeAssert(begin < end && *begin == '{');
+	++begin;
+
+	// A value without quotes ends before "}" here.
+	mValueEndChar = '}';
+
+	while(begin < end)
+	{
+		bool ok = false;
+		BiTreePropertyManager::PropertyRecord propertyRecord;
+		std::string propertyName;
+		std::string propertyValue;
+		PropertyValue value;
+
+		begin = getPropertyName(begin, end, ok, propertyName);
+		if(!ok)
+		{
+			PrintError("Invalid inline property name.\n");
+			break;
+		}
+		if(!BiTreePropertyManager::isPropertyNameValid(propertyName, propertyRecord))
+		{
+			PrintError("Invalid property name: [%s]\n", propertyName.c_str());
+			break;
+		}
+		if(propertyRecord.isExtendProperty)
+		{
+			PrintError("Extend property: [%s] cannot be used as inline property.\n",
+					   propertyName.c_str());
+			break;
+		}
+
+		begin = trimEq(begin, end, ok);
+		if(!ok)
+		{
+			PrintError("Inline property: [%s] has no \"=\".\n", propertyName.c_str());
+			break;
+		}
+
+		if(propertyRecord.valueType == BiTreePropertyManager::PropertyRecord::ElementValueType::Uint32)
+		{
+			begin = getValueUint32(begin, end, ok, propertyValue);
+		}
+		else
+		{
+			begin = getValueString(begin, end, ok, propertyValue);
+		}
+
+		ok = ok && BiTreePropertyManager::isPropertyValueValid(propertyRecord, propertyValue, value);
+		if(!ok)
+		{
+			PrintError("Property-value is invalid: [%s = %s].\n",
+					   propertyName.c_str(),
+					   propertyValue.c_str());
+			break;
+		}
+
+		if(!mIsCheckOnly)
+		{
+			BiTreeAssert(mNodeInfoArray != nullptr);
+			mNodeInfoArray->setValue(inlineNodeInfo, propertyRecord.elementIndexOrId, value);
+		}
+
+		// Try to get next "key = value", or "}" means parsing end.
+		begin = trimFrontSpaceAndComma(begin, end);
+		if(begin < end && *begin == '}')
+		{
+			++begin;
+			status = true;
+			break;
+		}
+	}
+
+	mValueEndChar = ']';
+
+	if(status && !mIsCheckOnly)
+	{
+		BiTreeAssert(mNodeInfoArray != nullptr);
+		nodeInfo = mNodeInfoArray->addInlineNodeInfo(std::move(inlineNodeInfo));
+	}
+
+	return begin;
+}
+
 
 
 //
 // BiTreeParser-------------------------------------------------------
 //
 BiTreeParser::BiTreeParser()
-	: mRoot(nullptr),mPropertyParser(nullptr)
+	: mRoot(nullptr),mPropertyParser(nullptr),mLabelPool(nullptr)
 {
 	BiTreeAssert(mPropertyParser==nullptr);
 	mPropertyParser=new BiTreePropertyParser();
 	BiTreeAssert(mPropertyParser!=nullptr);
+
+	BiTreeAssert(mLabelPool==nullptr);
+	mLabelPool=new LabelPool();
+	BiTreeAssert(mLabelPool!=nullptr);
 }
 
 BiTreeParser::~BiTreeParser()
@@ -519,6 +824,11 @@ BiTreeParser::~BiTreeParser()
 		delete mPropertyParser;
 		mPropertyParser=nullptr;
 	}
+	if(mLabelPool)
+	{
+		delete mLabelPool;
+		mLabelPool=nullptr;
+	}
 }
 const std::size_t& BiTreeParser::getMaxTokenSizeCurrent()
 {
@@ -561,6 +871,12 @@ const NodeInfoArray* BiTreeParser::getNodeInfoArray()const
 	return mPropertyParser->getNodeInfoArray();
 }
 
+const LabelPool* BiTreeParser::getLabelPool()const
+{
+	BiTreeAssert(mLabelPool!=nullptr);
+	return mLabelPool;
+}
+
 BiTreeParser::TokenArray BiTreeParser::getTokenArray(const std::string& text)
 {
 	TokenArray tokenArray;
@@ -581,7 +897,7 @@ BiTreeParser::TokenArray BiTreeParser::getTokenArray(const std::string& text)
 		{
 			++it;
 		}
-		if(*it == '(')
+		else if(*it == '(')
 		{
 			++it;
 			tokenArray.push_back(Token(TokenName::Lp));
@@ -596,25 +912,49 @@ BiTreeParser::TokenArray BiTreeParser::getTokenArray(const std::string& text)
 			++it;
 			tokenArray.push_back(Token(TokenName::Comma));
 		}
+		else if(*it == '{')
+		{
+			// Inline properties of the node just before it.
+			if(tokenArray.empty() || tokenArray.back().name != TokenName::Int ||
+			   tokenArray.back().nodeInfo != nullptr)
+			{
+				PrintError("Found \"{\" not just after a node.\n");
+				tokenArray.clear();
+				break;
+			}
+
+			bool status = false;
+			auto propertyBegin = it;
+			it = mPropertyParser->parsingInline(it, text.end(), status, tokenArray.back().nodeInfo);
+			if(!status)
+			{
+				PrintError("Parsing inline property failed:\n%s\n",
+						   std::string(propertyBegin, it).c_str());
+				tokenArray.clear();
+				break;
+			}
+		}
 		else if(isDataChar(*it))
 		{
-			std::string subStr;
+			auto tokenBegin = it;
 			std::size_t i = 0;
 			while(it != text.end() && isDataChar(*it))
 			{
-				subStr.push_back(*it);
 				++it;
 				++i;
 				if(i > maxTokenSizeAllowed)
 				{
 					PrintError("Found a token.size() overflow. maxTokenSizeAllowed=%d\n",
 							   maxTokenSizeAllowed);
-					PrintError("The token is:\n%s\n", subStr.c_str());
+					PrintError("The token is:\n%s\n", std::string(tokenBegin, it).c_str());
 					tokenArray.clear();
 					return tokenArray;
 				}
 			}
-			tokenArray.push_back(Token(TokenName::Int, subStr));
+
+			// Intern the label without creating a temporary string.
+			auto labelId = mLabelPool->intern(std::string_view(&*tokenBegin, i));
+			tokenArray.push_back(Token(TokenName::Int, labelId));
 			if(maxTokenSizeCurrent < i)
 			{
 				maxTokenSizeCurrent = i;
@@ -644,6 +984,7 @@ BiTreeParser::TokenArray BiTreeParser::getTokenArray(const std::string& text)
 
 bool BiTreeParser::parsing(const std::string& text)
 {
+	maxTokenSizeCurrent = 0;
 	auto tokenArray = getTokenArray(text);
 	if(tokenArray.empty())
 	{
@@ -693,8 +1034,9 @@ bool BiTreeParser::parsing(const std::string& text)
 
 			// build bitree 001;
 			auto node = biTreeNodeStack.top();
-			*node=new BiTreeNode(it->value);
+			*node=new BiTreeNode(it->labelId);
 			BiTreeAssert(*node!=nullptr);
+			(*node)->nodeInfo = it->nodeInfo;
 			
 			biTreeNodeStack.pop();
 			biTreeNodeStack.push(&((*node)->rightChild));
@@ -708,8 +1050,9 @@ bool BiTreeParser::parsing(const std::string& text)
 
 			// build bitree 002;
 			auto node = biTreeNodeStack.top();
-			*node=new BiTreeNode(it->value);
+			*node=new BiTreeNode(it->labelId);
 			BiTreeAssert(*node!=nullptr);
+			(*node)->nodeInfo = it->nodeInfo;
 
 			biTreeNodeStack.pop();
 			biTreeNodeStack.push(node);
@@ -740,9 +1083,9 @@ bool BiTreeParser::parsing(const std::string& text)
 		}
 		default:
 			PrintError("StackTop: [%s], looking1: [%s], looking2: [%s].\n",
-					   tokenStack.top().value.c_str(),
-					   it->value.c_str(),
-					   token2.value.c_str());
+					   getTokenValueStr(tokenStack.top()).c_str(),
+					   getTokenValueStr(*it).c_str(),
+					   getTokenValueStr(token2).c_str());
 			good = false;
 			break;
 		}
@@ -773,9 +1116,12 @@ bool BiTreeParser::parsing(const std::string& text)
 		if(tokenArray.size() == 2 && tokenArray.front().name == TokenName::Int)
 		{
 			// Renew maxTokenSizeCurrent for the layouter to calcluate the best radius for the node.
-			maxTokenSizeCurrent = tokenArray.front().value.size();
+			maxTokenSizeCurrent = mLabelPool->get(tokenArray.front().labelId).size();
 			// Create one node;
-			return new BiTreeNode(tokenArray.front().value);
+			auto node = new BiTreeNode(tokenArray.front().labelId);
+			BiTreeAssert(node != nullptr);
+			node->nodeInfo = tokenArray.front().nodeInfo;
+			return node;
 		}
 		return (BiTreeNode*)nullptr;
 	};
@@ -846,10 +1192,15 @@ void BiTreeParser::freeBiTree(BiTreeNode** root)
 //
 BiTreeParser::BiTreePropertyParser::BiTreePropertyParser()
 	:mNodeInfoArray(nullptr)
+	,mPropertyManager(nullptr)
 {
 	BiTreeAssert(mNodeInfoArray==nullptr);
 	mNodeInfoArray=new NodeInfoArray;
 	BiTreeAssert(mNodeInfoArray!=nullptr);
+
+	BiTreeAssert(mPropertyManager==nullptr);
+	mPropertyManager=new BiTreePropertyManager;
+	BiTreeAssert(mPropertyManager!=nullptr);
 }
 BiTreeParser::BiTreePropertyParser::~BiTreePropertyParser()
 {
@@ -858,6 +1209,11 @@ BiTreeParser::BiTreePropertyParser::~BiTreePropertyParser()
 		delete mNodeInfoArray;
 		mNodeInfoArray=nullptr;
 	}
+	if(mPropertyManager)
+	{
+		delete mPropertyManager;
+		mPropertyManager=nullptr;
+	}
 }
 
 
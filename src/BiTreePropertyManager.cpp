@@ -11,485 +11,473 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 */
 
 #include "bitreeviz/BiTreePropertyManager.h"
+#include "bitreeviz/BiTreeColorMap.h"
+
+#include <array>
+#include <charconv>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <type_traits>
+#include <unordered_map>
 
 using namespace bitree;
 
 //
-// Property value checke functions, each property has a check function.
+// Property schema, each property is one line, the value type and scope are decided by its member.
 //
-static bool CheckDefaultUint32(const std::string& inputValue, std::any& outputValue)
+using Base = BiTreePropertyManager::NodeBaseProperty;
+using Extend = BiTreePropertyManager::NodeProperty::NodeExtendProperty;
+using PropertyRecord = BiTreePropertyManager::PropertyRecord;
+
+// Set each property's index to its position of the table.
+static constexpr std::array<PropertyRecord, PropertyCount>
+MakePropertyTable(std::array<PropertyRecord, PropertyCount> table)
 {
-	auto v = std::stoul(inputValue, nullptr, 0);
-	if(v <= UINT32_MAX)
+	for(uint32_t i = 0; i < PropertyCount; i++)
 	{
-		outputValue = (uint32_t)v;
-		return true;
+		table[i].elementIndexOrId = i;
 	}
 
-	return false;
+	return table;
 }
 
-static bool CheckNodeId(const std::string& inputValue, std::any& outputValue)
-{
-	auto v = std::stoul(inputValue, nullptr, 0);
-	if(v <= NodeIdMax)
-	{
-		outputValue = (uint32_t)v;
-		return true;
-	}
+static constexpr std::array<PropertyRecord, PropertyCount> propertyTable = MakePropertyTable({{
+	// Node base property.
+	{"NodeLabel", 				NodeLabelStrLenMin, 			NodeLabelyStrLenMax, 			&Base::nodeLabel},
+	{"NodeRadius", 				NodeRadiusMin, 					NodeRadiusMax, 					&Base::nodeRadius},
+	{"BorderColor", 			0, 								UINT32_MAX, 					&Base::borderColor},
+	{"BorderWidth", 			BorderWidthMin, 				BorderWidthMax, 				&Base::borderWidth},
+	{"BorderDash", 				BorderDashStringLengthMin, 		BorderDashStringLengthMax, 		&Base::borderDash, 		&Base::borderDashId},
+	{"FillColor", 				0, 								UINT32_MAX, 					&Base::fillColor},
+	{"EdgeColor", 				0, 								UINT32_MAX, 					&Base::edgeColor},
+	{"EdgeWidth", 				EdgeWidthMin, 					EdgeWidthMax, 					&Base::edgeWidth},
+	{"EdgeDash", 				EdgeDashStringLengthMin, 		EdgeDashStringLengthMax, 		&Base::edgeDash, 			&Base::edgeDashId},
+	{"FontColor", 				0, 								UINT32_MAX, 					&Base::fontColor},
+	{"ColorMapValue", 			ColorMapValueMin, 				ColorMapValueMax, 				&Base::colorMapValue},
 
-	return false;
-}
+	// Node extend property, public used only.
+	{"FontFamily", 				FontFamilyStrLenMin, 			FontFamilyStrLenMax, 			&Extend::fontFamily},
+	{"FontSize", 				FontSizeMin, 					FontSizeMax, 					&Extend::fontSize},
+	{"FontSlant", 				FontSlantMin, 					FontSlantMax, 					&Extend::fontSlant},
+	{"FontWeight", 				FontWeightMin, 					FontWeightMax, 					&Extend::fontWeight},
+	{"RadiusIncrement", 		RadiusIncrementMin, 			RadiusIncrementMax, 			&Extend::radiusIncrement},
+	{"EdgeXIncrement", 			EdgeXIncrementMin, 				EdgeXIncrementMax, 				&Extend::edgeXIncrement},
+	{"EdgeYIncrement", 			EdgeYIncrementMin, 				EdgeYIncrementMax, 				&Extend::edgeYIncrement},
+	{"PageBackgroundColor", 	PageBackgroundColorMin, 		PageBackgroundColorMax, 		&Extend::pageBackgroundColor},
+	{"PageMarginXIncrement", 	PageMarginXIncrementMin, 		PageMarginXIncrementMax, 		&Extend::pageMarginXIncrement},
+	{"PageMarginYIncrement", 	PageMarginYIncrementMin, 		PageMarginYIncrementMax, 		&Extend::pageMarginYIncrement},
+	{"FillColorMap", 			ColorMapStringLengthMin, 		ColorMapStringLengthMax, 		&Extend::fillColorMap, 		&BiTreeColorMap::isGradientValid},
+	{"BorderColorMap", 			ColorMapStringLengthMin, 		ColorMapStringLengthMax, 		&Extend::borderColorMap, 	&BiTreeColorMap::isGradientValid},
+	{"ColorMapMin", 			ColorMapMinMin, 				ColorMapMinMax, 				&Extend::colorMapMin},
+	{"ColorMapMax", 			ColorMapMaxMin, 				ColorMapMaxMax, 				&Extend::colorMapMax}
+	}});
 
-static bool CheckNodeLabel(const std::string& inputValue, std::any& outputValue)
-{
-	auto size = inputValue.size();
-	if(NodeLabelStrLenMin <= size && size <= NodeLabelyStrLenMax)
-	{
-		outputValue = inputValue;
-		return true;
-	}
+//
+// Perfect hash of the property names, the seed is searched at compile time.
+//
+constexpr uint32_t PropertyHashTableBits = 6;
+constexpr uint32_t PropertyHashTableSize = 1u << PropertyHashTableBits;
+constexpr uint32_t PropertyHashSeedMax = 10000;
+constexpr uint8_t PropertyHashSlotEmpty = UINT8_MAX;
 
-	return false;
-}
+static_assert(PropertyCount < PropertyHashTableSize, "Property hash table is too small.");
 
-static bool CheckNodeRadius(const std::string& inputValue, std::any& outputValue)
+// FNV-1a with a seed, the high bits are used as they depend on all the chars.
+static constexpr uint32_t HashPropertyName(std::string_view name, uint32_t seed)
 {
-	auto v = std::stoul(inputValue, nullptr, 0);
-	if(NodeRadiusMin <= v && v <= NodeRadiusMax)
+	uint32_t hash = 2166136261u ^ seed;
+	for(auto ch : name)
 	{
-		outputValue = (uint32_t)v;
-		return true;
+		hash ^= (uint8_t)ch;
+		hash *= 16777619u;
 	}
 
-	return false;
+	return hash >> (32 - PropertyHashTableBits);
 }
 
-static bool CheckBorderWidth(const std::string& inputValue, std::any& outputValue)
+static constexpr uint32_t FindPropertyHashSeed()
 {
-	auto v = std::stoul(inputValue, nullptr, 0);
-	if(BorderWidthMin <= v && v <= BorderWidthMax)
+	for(uint32_t seed = 0; seed < PropertyHashSeedMax; seed++)
 	{
-		outputValue = (uint32_t)v;
-		return true;
+		bool isSlotUsed[PropertyHashTableSize] = {};
+		bool isPerfect = true;
+		for(auto const& propertyRecord : propertyTable)
+		{
+			auto slot = HashPropertyName(propertyRecord.propertyName, seed);
+			isPerfect = isPerfect && !isSlotUsed[slot];
+			isSlotUsed[slot] = true;
+		}
+		if(isPerfect)
+		{
+			return seed;
+		}
 	}
 
-	return false;
+	return PropertyHashSeedMax;
 }
 
-static bool CheckBorderDash(const std::string& inputValue, std::any& outputValue)
+static constexpr uint32_t PropertyHashSeed = FindPropertyHashSeed();
+static_assert(PropertyHashSeed < PropertyHashSeedMax, "No perfect hash seed for the property names.");
+
+// Slot of the name's hash to its property-index.
+static constexpr std::array<uint8_t, PropertyHashTableSize> MakePropertyHashTable()
 {
-	auto size = inputValue.size();
-	if(BorderDashStringLengthMin <= size && size <= BorderDashStringLengthMax)
+	std::array<uint8_t, PropertyHashTableSize> hashTable{};
+	for(auto& index : hashTable)
 	{
-		outputValue = inputValue;
-		return true;
+		index = PropertyHashSlotEmpty;
 	}
-
-	return false;
-}
-
-static bool CheckEdgeWidth(const std::string& inputValue, std::any& outputValue)
-{
-	auto v = std::stoul(inputValue, nullptr, 0);
-	if(EdgeWidthMin <= v && v <= EdgeWidthMax)
+	for(auto const& propertyRecord : propertyTable)
 	{
-		outputValue = (uint32_t)v;
-		return true;
+		hashTable[HashPropertyName(propertyRecord.propertyName, PropertyHashSeed)] =
+			(uint8_t)propertyRecord.elementIndexOrId;
 	}
 
-	return false;
+	return hashTable;
 }
 
-static bool CheckEdgeDash(const std::string& inputValue, std::any& outputValue)
-{
-	auto size = inputValue.size();
-	if(EdgeDashStringLengthMin <= size && size <= EdgeDashStringLengthMax)
-	{
-		outputValue = inputValue;
-		return true;
-	}
+static constexpr std::array<uint8_t, PropertyHashTableSize> propertyHashTable = MakePropertyHashTable();
 
-	return false;
-}
+//
+// Typed value check and setters.
+//
 
-static bool CheckFontSize(const std::string& inputValue, std::any& outputValue)
+// Parse a Uint32 value, the same as std::stoul(valueStr, nullptr, 0) without exception.
+static bool ParseUint32(std::string_view valueStr, uint32_t& value)
 {
-	auto v = std::stoul(inputValue, nullptr, 0);
-	if(FontSizeMin <= v && v <= FontSizeMax)
+	int base = 10;
+	auto begin = valueStr.data();
+	auto end = valueStr.data() + valueStr.size();
+	if(valueStr.size() > 2 && valueStr[0] == '0' && (valueStr[1] == 'x' || valueStr[1] == 'X'))
 	{
-		outputValue = (uint32_t)v;
-		return true;
+		base = 16;
+		begin += 2;
+	}
+	else if(valueStr.size() > 1 && valueStr[0] == '0')
+	{
+		base = 8;
+		begin += 1;
 	}
 
-	return false;
-}
-
-static bool CheckFontWeight(const std::string& inputValue, std::any& outputValue)
-{
-	auto v = std::stoul(inputValue, nullptr, 0);
-	if(FontWeightMin <= v && v <= FontWeightMax)
+	uint32_t v = 0;
+	auto result = std::from_chars(begin, end, v, base);
+	if(begin < end && result.ec == std::errc() && result.ptr == end)
 	{
-		outputValue = (uint32_t)v;
+		value = v;
 		return true;
 	}
 
 	return false;
 }
 
-static bool CheckFontFamily(const std::string& inputValue, std::any& outputValue)
+bool PropertyRecord::checkValue(const std::string& inputValue, PropertyValue& outputValue) const
 {
-	auto size = inputValue.size();
-	if(FontFamilyStrLenMin <= size && size <= FontFamilyStrLenMax)
+	if(valueType == ElementValueType::String)
 	{
-		outputValue = inputValue;
+		auto size = inputValue.size();
+		if(size < valueMin || valueMax < size || (isStringValid != nullptr && !isStringValid(inputValue)))
+		{
+			return false;
+		}
+
+		// A dash string is parsed here once, the nodes only keep its dash id.
+		outputValue.dashId = DashIdNone;
+		if(baseDashId)
+		{
+			outputValue.dashId = BiTreePropertyManager::internDash(inputValue);
+			if(outputValue.dashId == DashIdNone)
+			{
+				return false;
+			}
+		}
+
+		outputValue.string = inputValue;
+		outputValue.isString = true;
 		return true;
 	}
 
-	return false;
-}
-
-static bool CheckFontSlant(const std::string& inputValue, std::any& outputValue)
-{
-	auto v = std::stoul(inputValue, nullptr, 0);
-	if(FontSlantMin <= v && v <= FontSlantMax)
+	uint32_t v = 0;
+	if(ParseUint32(inputValue, v) && valueMin <= v && v <= valueMax)
 	{
-		outputValue = (uint32_t)v;
+		outputValue.number = v;
 		return true;
 	}
 
 	return false;
 }
 
-static bool CheckRadiusIncrement(const std::string& inputValue, std::any& outputValue)
+void PropertyRecord::setNumber(NodeProperty& nodeProperty, const uint32_t& number) const
 {
-	auto v = std::stoul(inputValue, nullptr, 0);
-	if(RadiusIncrementMin <= v && v <= RadiusIncrementMax)
+	if(baseUint32)
 	{
-		outputValue = (uint32_t)v;
-		return true;
+		nodeProperty.nodeBaseProperty.*baseUint32 = number;
+	}
+	else if(extendUint32)
+	{
+		nodeProperty.nodeExtendProperty.*extendUint32 = number;
 	}
-
-	return false;
 }
 
-static bool CheckEdgeXIncrement(const std::string& inputValue, std::any& outputValue)
+void PropertyRecord::setString(NodeProperty& nodeProperty, std::string_view string, const uint32_t& dashId) const
 {
-	auto v = std::stoul(inputValue, nullptr, 0);
-	if(EdgeXIncrementMin <= v && v <= EdgeXIncrementMax)
+	if(baseString)
 	{
-		outputValue = (uint32_t)v;
-		return true;
+		nodeProperty.nodeBaseProperty.*baseString = string;
+		if(baseDashId)
+		{
+			nodeProperty.nodeBaseProperty.*baseDashId = dashId;
+		}
+	}
+	else if(extendString)
+	{
+		nodeProperty.nodeExtendProperty.*extendString = string;
 	}
-
-	return false;
 }
 
-static bool CheckEdgeYIncrement(const std::string& inputValue, std::any& outputValue)
+void PropertyRecord::setValue(NodeProperty& nodeProperty, const PropertyValue& value) const
 {
-	auto v = std::stoul(inputValue, nullptr, 0);
-	if(EdgeYIncrementMin <= v && v <= EdgeYIncrementMax)
+	if(valueType == ElementValueType::String)
 	{
-		outputValue = (uint32_t)v;
-		return true;
+		setString(nodeProperty, value.string, value.dashId);
+	}
+	else
+	{
+		setNumber(nodeProperty, value.number);
 	}
-
-	return false;
 }
 
-static bool CheckPageBackgroundColor(const std::string& inputValue, std::any& outputValue)
+bool BiTreePropertyManager::isNodeIdValid(const uint32_t& nodeId)
 {
-	auto v = std::stoul(inputValue, nullptr, 0);
-	if(PageBackgroundColorMin <= v && v <= PageBackgroundColorMax)
+	if(nodeId <= NodeIdMax)
 	{
-		outputValue = (uint32_t)v;
 		return true;
 	}
 
 	return false;
 }
 
-static bool CheckPageMarginXIncrement(const std::string& inputValue, std::any& outputValue)
+bool BiTreePropertyManager::isNodeIdValid(const std::string& nodeIdStr, uint32_t& nodeId)
 {
-	auto v = std::stoul(inputValue, nullptr, 0);
-	if(PageMarginXIncrementMin <= v && v <= PageMarginXIncrementMax)
+	auto v = LabelPool::toNodeId(nodeIdStr);
+	if(v != NodeIdInvalid)
 	{
-		outputValue = (uint32_t)v;
+		nodeId = v;
 		return true;
 	}
 
 	return false;
 }
 
-static bool CheckPageMarginYIncrement(const std::string& inputValue, std::any& outputValue)
+bool BiTreePropertyManager::isPropertyNameValid(const std::string& name,
+												PropertyRecord& outputPropertyRecord)
 {
-	auto v = std::stoul(inputValue, nullptr, 0);
-	if(PageMarginYIncrementMin <= v && v <= PageMarginYIncrementMax)
+	auto index = propertyHashTable[HashPropertyName(name, PropertyHashSeed)];
+	if(index != PropertyHashSlotEmpty && propertyTable[index].propertyName == name)
 	{
-		outputValue = (uint32_t)v;
+		outputPropertyRecord = propertyTable[index];
 		return true;
 	}
 
 	return false;
 }
 
-//
-// Sender functions. it can use cached nodeInfo or user-input to update current node-properties.
-//
-static void SendNodeLabel(const NodeInfo::element_t& element,
-						  BiTreePropertyManager::NodeProperty& nodeProperty)
-{
-	nodeProperty.nodeBaseProperty.nodeLabel = std::any_cast<std::string>(element.value);
-}
-
-static void SendNodeRadius(const NodeInfo::element_t& element,
-							BiTreePropertyManager::NodeProperty& nodeProperty)
-{
-	nodeProperty.nodeBaseProperty.nodeRadius = std::any_cast<uint32_t>(element.value);
-}
-
-
-static void SendBorderColor(const NodeInfo::element_t& element,
-							BiTreePropertyManager::NodeProperty& nodeProperty)
+bool BiTreePropertyManager::isPropertyValueValid(const PropertyRecord& inputPropertyRecord,
+												 const std::string& valueString,
+												 PropertyValue& valueOutput)
 {
-	nodeProperty.nodeBaseProperty.borderColor = std::any_cast<uint32_t>(element.value);
+	return inputPropertyRecord.checkValue(valueString, valueOutput);
 }
 
-static void SendBorderWidth(const NodeInfo::element_t& element,
-							BiTreePropertyManager::NodeProperty& nodeProperty)
+BiTreePropertyManager::PropertyRecord::ElementValueType
+BiTreePropertyManager::getElementValueType(const uint32_t& elementIndex)
 {
-	nodeProperty.nodeBaseProperty.borderWidth = std::any_cast<uint32_t>(element.value);
-}
+	BiTreeAssert(elementIndex < PropertyCount);
 
-static void SendBorderDash(const NodeInfo::element_t& element,
-						  BiTreePropertyManager::NodeProperty& nodeProperty)
-{
-	nodeProperty.nodeBaseProperty.borderDash = std::any_cast<std::string>(element.value);
+	return propertyTable[elementIndex].valueType;
 }
 
-static void SendFillColor(const NodeInfo::element_t& element,
-						  BiTreePropertyManager::NodeProperty& nodeProperty)
-{
-	nodeProperty.nodeBaseProperty.fillColor = std::any_cast<uint32_t>(element.value);
-}
-static void SendEdgeColor(const NodeInfo::element_t& element,
-						  BiTreePropertyManager::NodeProperty& nodeProperty)
-{
-	nodeProperty.nodeBaseProperty.edgeColor = std::any_cast<uint32_t>(element.value);
-}
-static void SendEdgeWidth(const NodeInfo::element_t& element,
-						  BiTreePropertyManager::NodeProperty& nodeProperty)
+bool BiTreePropertyManager::getPropertyRecordBy(
+	const std::string& prpoertyNameStr, BiTreePropertyManager::PropertyRecord& propertyRecord)
 {
-	nodeProperty.nodeBaseProperty.edgeWidth = std::any_cast<uint32_t>(element.value);
+	return isPropertyNameValid(prpoertyNameStr, propertyRecord);
 }
 
-static void SendEdgeDash(const NodeInfo::element_t& element,
-						  BiTreePropertyManager::NodeProperty& nodeProperty)
+bool BiTreePropertyManager::parseDash(std::string_view dashStr, std::vector<double>& dashArray)
 {
-	nodeProperty.nodeBaseProperty.edgeDash = std::any_cast<std::string>(element.value);
-}
+	auto isSeparator = [](char ch) {
+		return ch == ' ' || ch == '\t' || ch == '"' || ch == ';' || ch == ',' || ch == '|' || ch == ':';
+	};
 
-static void SendFontColor(const NodeInfo::element_t& element,
-						  BiTreePropertyManager::NodeProperty& nodeProperty)
-{
-	nodeProperty.nodeBaseProperty.fontColor = std::any_cast<uint32_t>(element.value);
-}
+	dashArray.clear();
+	auto begin = dashStr.data();
+	auto end = dashStr.data() + dashStr.size();
+	while(true)
+	{
+		while(begin < end && isSeparator(*begin))
+			++begin;
+		if(begin == end)
+		{
+			break;
+		}
 
-static void SendFontFamily(const NodeInfo::element_t& element,
-						   BiTreePropertyManager::NodeProperty& nodeProperty)
-{
-	nodeProperty.nodeExtendProperty.fontFamily = std::any_cast<std::string>(element.value);
-}
+		// A unit is the same as a Uint32 value, decimal, hex after "0x" or octal after "0".
+		auto unitEnd = begin;
+		while(unitEnd < end && !isSeparator(*unitEnd))
+			++unitEnd;
 
-static void SendFontSize(const NodeInfo::element_t& element,
-						 BiTreePropertyManager::NodeProperty& nodeProperty)
-{
-	nodeProperty.nodeExtendProperty.fontSize = std::any_cast<uint32_t>(element.value);
-}
+		// The units end at the first invalid one, such as a 0 ending "2,2,0", the units before it are kept.
+		uint32_t unit = 0;
+		if(!ParseUint32(std::string_view(begin, unitEnd - begin), unit) || unit < DashUnitMin || DashUnitMax < unit)
+		{
+			break;
+		}
+		dashArray.push_back((double)unit);
+		begin = unitEnd;
+	}
 
-static void SendFontSlant(const NodeInfo::element_t& element,
-						  BiTreePropertyManager::NodeProperty& nodeProperty)
-{
-	nodeProperty.nodeExtendProperty.fontSlant = std::any_cast<uint32_t>(element.value);
-}
-static void SendFontWeight(const NodeInfo::element_t& element,
-						   BiTreePropertyManager::NodeProperty& nodeProperty)
-{
-	nodeProperty.nodeExtendProperty.fontWeight = std::any_cast<uint32_t>(element.value);
-}
-static void SendRadiusIncrement(const NodeInfo::element_t& element,
-								BiTreePropertyManager::NodeProperty& nodeProperty)
-{
-	nodeProperty.nodeExtendProperty.radiusIncrement = std::any_cast<uint32_t>(element.value);
-}
-static void SendEdgeXIncrement(const NodeInfo::element_t& element,
-							   BiTreePropertyManager::NodeProperty& nodeProperty)
-{
-	nodeProperty.nodeExtendProperty.edgeXIncrement = std::any_cast<uint32_t>(element.value);
-}
-static void SendEdgeYIncrement(const NodeInfo::element_t& element,
-							   BiTreePropertyManager::NodeProperty& nodeProperty)
-{
-	nodeProperty.nodeExtendProperty.edgeYIncrement = std::any_cast<uint32_t>(element.value);
-}
+	if(dashArray.size() < 2)
+	{
+		dashArray.clear();
+		return false;
+	}
 
-static void SendPageBackgroundColor(const NodeInfo::element_t& element,
-									BiTreePropertyManager::NodeProperty& nodeProperty)
-{
-	nodeProperty.nodeExtendProperty.pageBackgroundColor = std::any_cast<uint32_t>(element.value);
+	return true;
 }
 
-static void SendPageMarginXIncrement(const NodeInfo::element_t& element,
-									BiTreePropertyManager::NodeProperty& nodeProperty)
+// Units of all the dash strings, the dash ids of every document share it, so it is locked.
+struct DashPool
 {
-	nodeProperty.nodeExtendProperty.pageMarginXIncrement = std::any_cast<uint32_t>(element.value);
-}
+	std::mutex mutex;
+	std::unordered_map<std::string, uint32_t> dashIdMap; 	// Dash string to its dash id.
+	std::deque<std::vector<double>> dashArray; 			// Units indexed by dash id, the deque keeps them in place.
+};
 
-static void SendPageMarginYIncrement(const NodeInfo::element_t& element,
-									BiTreePropertyManager::NodeProperty& nodeProperty)
+static DashPool& GetDashPool()
 {
-	nodeProperty.nodeExtendProperty.pageMarginYIncrement = std::any_cast<uint32_t>(element.value);
+	static DashPool dashPool;
+	return dashPool;
 }
 
-typedef BiTreePropertyManager::PropertyRecord::ElementValueType vt;
-const std::vector<BiTreePropertyManager::PropertyRecord> BiTreePropertyManager::propertyTable = {
-	// Node base property.
-	{getNextId(), 	"NodeLabel", 			vt::String, 0, 0, CheckNodeLabel, 			SendNodeLabel},
-	{getNextId(),	"NodeRadius",			vt::Uint32,	0, 0, CheckNodeRadius,			SendNodeRadius},
-	{getNextId(), 	"BorderColor",			vt::Uint32, 0, 0, CheckDefaultUint32, 		SendBorderColor},
-	{getNextId(), 	"BorderWidth", 			vt::Uint32, 0, 0, CheckBorderWidth, 		SendBorderWidth},
-	{getNextId(), 	"BorderDash", 			vt::String, 0, 0, CheckBorderDash, 			SendBorderDash},
-	{getNextId(), 	"FillColor", 			vt::Uint32, 0, 0, CheckDefaultUint32, 		SendFillColor},
-	{getNextId(), 	"EdgeColor", 			vt::Uint32, 0, 0, CheckDefaultUint32, 		SendEdgeColor},
-	{getNextId(), 	"EdgeWidth", 			vt::Uint32, 0, 0, CheckEdgeWidth, 			SendEdgeWidth},
-	{getNextId(), 	"EdgeDash", 			vt::String, 0, 0, CheckEdgeDash, 			SendEdgeDash},
-	{getNextId(), 	"FontColor", 			vt::Uint32, 0, 0, CheckDefaultUint32, 		SendFontColor},
-
-	// Node extend property, public used only.
-	{getNextId(), 	"FontFamily", 			vt::String, 1, 0, CheckFontFamily, 			SendFontFamily},
-	{getNextId(), 	"FontSize", 			vt::Uint32, 1, 0, CheckFontSize, 			SendFontSize},
-	{getNextId(), 	"FontSlant", 			vt::Uint32, 1, 0, CheckFontSlant, 			SendFontSlant},
-	{getNextId(), 	"FontWeight", 			vt::Uint32, 1, 0, CheckFontWeight, 			SendFontWeight},
-	{getNextId(), 	"RadiusIncrement", 		vt::Uint32, 1, 0, CheckRadiusIncrement, 	SendRadiusIncrement},
-	{getNextId(), 	"EdgeXIncrement", 		vt::Uint32, 1, 0, CheckEdgeXIncrement, 		SendEdgeXIncrement},
-	{getNextId(), 	"EdgeYIncrement", 		vt::Uint32, 1, 0, CheckEdgeYIncrement, 		SendEdgeYIncrement},
-	{getNextId(), 	"PageBackgroundColor", 	vt::Uint32, 1, 0, CheckPageBackgroundColor, SendPageBackgroundColor},
-	{getNextId(), 	"PageMarginXIncrement", vt::Uint32, 1, 0, CheckPageMarginXIncrement, SendPageMarginXIncrement},
-	{getNextId(), 	"PageMarginYIncrement", vt::Uint32, 1, 0, CheckPageMarginYIncrement, SendPageMarginYIncrement}
-	};
-
-const std::size_t BiTreePropertyManager::propertyTableSize =
-	BiTreePropertyManager::propertyTable.size();
-
-BiTreePropertyManager::NodeProperty BiTreePropertyManager::mCurrentNodeProperty =
-	BiTreePropertyManager::NodeProperty();
-BiTreePropertyManager::NodeProperty BiTreePropertyManager::mCurrentNodePropertyOverride =
-	BiTreePropertyManager::NodeProperty();
-
-bool BiTreePropertyManager::isNodeIdValid(const uint32_t& nodeId)
+uint32_t BiTreePropertyManager::internDash(std::string_view dashStr)
 {
-	if(nodeId <= NodeIdMax)
+	auto& dashPool = GetDashPool();
+	std::lock_guard<std::mutex> lock(dashPool.mutex);
+	if(dashPool.dashArray.empty())
 	{
-		return true;
+		dashPool.dashArray.emplace_back();
 	}
 
-	return false;
-}
-
-bool BiTreePropertyManager::isNodeIdValid(const std::string& nodeIdStr, uint32_t& nodeId)
-{
-	auto v = std::stoul(nodeIdStr, nullptr, 0);
-	if(v <= NodeIdMax)
+	auto result = dashPool.dashIdMap.emplace(std::string(dashStr), DashIdNone);
+	if(result.second)
 	{
-		nodeId = v;
-		return true;
+		std::vector<double> dashArray;
+		if(parseDash(dashStr, dashArray))
+		{
+			result.first->second = (uint32_t)dashPool.dashArray.size();
+			dashPool.dashArray.push_back(std::move(dashArray));
+		}
 	}
 
-	return false;
+	return result.first->second;
 }
 
-bool BiTreePropertyManager::isPropertyNameValid(const std::string& name,
-												PropertyRecord& outputPropertyRecord)
+const std::vector<double>& BiTreePropertyManager::getDash(const uint32_t& dashId)
 {
-	for(auto const& propertyRecord : propertyTable)
+	auto& dashPool = GetDashPool();
+	std::lock_guard<std::mutex> lock(dashPool.mutex);
+	if(dashPool.dashArray.empty())
 	{
-		if(propertyRecord.propertyName == name)
-		{
-			outputPropertyRecord = propertyRecord;
-			return true;
-		}
+		dashPool.dashArray.emplace_back();
 	}
 
-	return false;
-}
-
-bool BiTreePropertyManager::isPropertyValueValid(const PropertyRecord& inputPropertyRecord,
-												 const std::string& valueString,
-												 std::any& valueOutput)
-{
-	return inputPropertyRecord.checkValue(valueString, valueOutput);
+	BiTreeAssert(dashId < dashPool.dashArray.size());
+	return dashPool.dashArray[dashId];
 }
 
-BiTreePropertyManager::PropertyRecord::ElementValueType
-BiTreePropertyManager::getElementValueType(const uint32_t& elementIndex)
+const BiTreePropertyManager::NodeProperty&
+BiTreePropertyManager::getCurrentPropertyByUpdate(const NodeInfoArray& nodeInfoArray,
+												  const NodeInfo* nodeInfo,
+												  const NodeInfo* inlineNodeInfo)
 {
-	BiTreeAssert(elementIndex < propertyTableSize);
-
-	return propertyTable[elementIndex].valueType;
-}
+	mCurrentNodeProperty = mCurrentNodePropertyOverride;
 
-bool BiTreePropertyManager::getPropertyRecordBy(
-	const std::string& prpoertyNameStr, BiTreePropertyManager::PropertyRecord& propertyRecord)
-{
-	for(auto const& thisRecord : propertyTable)
+	for(auto const& info : {nodeInfo, inlineNodeInfo})
 	{
-		if(thisRecord.propertyName == prpoertyNameStr)
+		if(info == nullptr || info->empty())
+		{
+			continue;
+		}
+		for(auto const& propertyRecord : propertyTable)
 		{
-			propertyRecord = thisRecord;
-			return true;
+			auto const& index = propertyRecord.elementIndexOrId;
+			if(!info->has(index))
+			{
+				continue;
+			}
+
+			if(propertyRecord.valueType == PropertyRecord::ElementValueType::String)
+			{
+				auto stringId = info->get(index);
+				propertyRecord.setString(mCurrentNodeProperty, nodeInfoArray.getString(stringId), nodeInfoArray.getDashId(stringId));
+			}
+			else
+			{
+				propertyRecord.setNumber(mCurrentNodeProperty, info->get(index));
+			}
 		}
 	}
 
-	return false;
+	return mCurrentNodeProperty;
 }
 
-const BiTreePropertyManager::NodeProperty&
-BiTreePropertyManager::getCurrentPropertyByUpdate(const NodeInfo& nodeInfo)
+std::size_t BiTreePropertyManager::NodeProperty::hash() const
 {
-	mCurrentNodeProperty = mCurrentNodePropertyOverride;
+	std::size_t seed = 0;
+	auto combine = [&seed](const auto&... values) {
+		((seed ^= std::hash<std::decay_t<decltype(values)>>{}(values) + 0x9e3779b9 + (seed << 6) +
+				  (seed >> 2)),
+		 ...);
+	};
 
-	for(auto const& element : nodeInfo.getElementSet())
-	{
-		BiTreeAssert(element.index < propertyTableSize);
-		propertyTable[element.index].sender(element, mCurrentNodeProperty);
-	}
+	std::apply(combine, nodeBaseProperty.tie());
+	std::apply(combine, nodeExtendProperty.tie());
 
-	return mCurrentNodeProperty;
+	return seed;
 }
 
-const BiTreePropertyManager::NodeProperty& BiTreePropertyManager::getCurrentProperty()
+const BiTreePropertyManager::NodeProperty& BiTreePropertyManager::getCurrentProperty() const
 {
 	return mCurrentNodePropertyOverride;
 }
 
 bool BiTreePropertyManager::setCurrentProperty(
 	const BiTreePropertyManager::PropertyRecord& propertyRecord,
-	const std::any& value,
+	const PropertyValue& value,
 	bool globalOverride)
 {
-	BiTreeAssert(propertyRecord.elementIndexOrId < propertyTableSize);
-
-	NodeInfo::element_t element;
-	element.index = propertyRecord.elementIndexOrId;
-	element.value = value;
+	BiTreeAssert(propertyRecord.elementIndexOrId < PropertyCount);
 
-	propertyRecord.sender(element, mCurrentNodeProperty);
+	propertyRecord.setValue(mCurrentNodeProperty, value);
 
 	if(globalOverride)
 	{
-		propertyTable[propertyRecord.elementIndexOrId].isPropertyGlobalOverrided = globalOverride;
-		propertyRecord.sender(element, mCurrentNodePropertyOverride);
+		propertyRecord.setValue(mCurrentNodePropertyOverride, value);
 	}
 
 	return true;
 }
+
+bool BiTreePropertyManager::setCurrentProperty(const uint32_t& elementIndex,
+											   const PropertyValue& value,
+											   bool globalOverride)
+{
+	BiTreeAssert(elementIndex < PropertyCount);
+	return setCurrentProperty(propertyTable[elementIndex], value, globalOverride);
+}
+
+void BiTreePropertyManager::reset()
+{
+	mCurrentNodeProperty = NodeProperty();
+	mCurrentNodePropertyOverride = NodeProperty();
+}
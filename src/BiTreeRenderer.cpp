@@ -14,10 +14,26 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 #include "bitreeviz/BiTreeParser.h"
 #include "bitreeviz/BiTreePropertyManager.h"
 
+#include <algorithm>
+#include <atomic>
+#include <cctype>
 #include <cmath>
+#include <cstdio>
 #include <fstream>
+#include <functional>
+#include <map>
+#include <mutex>
 #include <sstream>
 #include <stack>
+#include <string_view>
+#include <thread>
+#include <tuple>
+#include <unordered_map>
+
+#ifdef _WIN32
+#	include <fcntl.h>
+#	include <io.h>
+#endif
 
 #pragma warning(disable : 4275)
 #pragma warning(disable : 4244)
@@ -26,11 +42,531 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 
 using namespace bitree;
 
+namespace
+{
+/**
+ * @brief Font faces and text extents shared by all the documents of the process.
+ * Labels usually repeat, so each of them is measured once for a font, not once for each node.
+ */
+class TextCache
+{
+public:
+	// The surfaces may have different font options, so their extents are not shared.
+	enum class Metrics
+	{
+		Layout, 	///< Measured on the image surface of getBestRadius.
+		Page, 		///< Measured on the pdf page surface.
+		Raster 		///< Measured on a tile of a png page, it depends on the scale too.
+	};
+
+	struct Font
+	{
+		Cairo::RefPtr<Cairo::ToyFontFace> fontFace;
+		std::unordered_map<std::string, Cairo::TextExtents> extentsMap; ///< Label to its extents.
+	};
+
+	/**
+	 * @brief Get the cached font of (family, slant, weight, size), it is created if not exist.
+	 * The returned pointer keeps valid until the process exits.
+	 */
+	static Font* getFont(Metrics metrics,
+						 const std::string& fontFamily,
+						 uint32_t fontSlant,
+						 uint32_t fontWeight,
+						 uint32_t fontSize,
+						 double scale = 1.0)
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+
+		// Faces only depend on (family, slant, weight), the fonts of other sizes reuse them.
+		auto& fontFace = mFontFaceMap[std::make_tuple(fontFamily, fontSlant, fontWeight)];
+		if(!fontFace)
+		{
+			fontFace = Cairo::ToyFontFace::create(fontFamily,
+												  (Cairo::ToyFontFace::Slant)fontSlant,
+												  (Cairo::ToyFontFace::Weight)fontWeight);
+		}
+
+		auto& font = mFontMap[std::make_tuple(metrics, scale, fontFamily, fontSlant, fontWeight, fontSize)];
+		if(!font.fontFace)
+		{
+			font.fontFace = fontFace;
+		}
+
+		return &font;
+	}
+
+	/**
+	 * @brief Get the extents of a text by the font set to cr, it is measured if not cached.
+	 */
+	static void getTextExtents(const Cairo::RefPtr<Cairo::Context>& cr,
+							   Font* font,
+							   const std::string& text,
+							   Cairo::TextExtents& extents)
+	{
+		{
+			std::lock_guard<std::mutex> lock(mMutex);
+			auto it = font->extentsMap.find(text);
+			if(it != font->extentsMap.end())
+			{
+				extents = it->second;
+				return;
+			}
+		}
+
+		cr->get_text_extents(text, extents);
+
+		// Unique labels such as the NodeIds are not worth caching, the memory is bounded.
+		std::lock_guard<std::mutex> lock(mMutex);
+		if(font->extentsMap.size() < ExtentsCountMax)
+		{
+			font->extentsMap.emplace(text, extents);
+		}
+	}
+
+private:
+	static constexpr std::size_t ExtentsCountMax = 64 * 1024;
+
+	static std::mutex mMutex;
+	static std::map<std::tuple<std::string, uint32_t, uint32_t>, Cairo::RefPtr<Cairo::ToyFontFace>> mFontFaceMap;
+	static std::map<std::tuple<Metrics, double, std::string, uint32_t, uint32_t, uint32_t>, Font> mFontMap;
+};
+
+std::mutex TextCache::mMutex;
+std::map<std::tuple<std::string, uint32_t, uint32_t>, Cairo::RefPtr<Cairo::ToyFontFace>> TextCache::mFontFaceMap;
+std::map<std::tuple<TextCache::Metrics, double, std::string, uint32_t, uint32_t, uint32_t>, TextCache::Font> TextCache::mFontMap;
+
+/**
+ * @brief A rectangle of the page in page units, the nodes out of it are not drawn.
+ */
+struct PageRect
+{
+	double x0;
+	double y0;
+	double x1;
+	double y1;
+
+	bool isOutside(double left, double top, double right, double bottom) const
+	{
+		return right < x0 || left > x1 || bottom < y0 || top > y1;
+	}
+};
+
+/**
+ * @brief Write the svg text by a large buffer, only the numbers and strings of the current element are formatted.
+ */
+class SvgWriter
+{
+public:
+	explicit SvgWriter(FILE* file)
+		: mFile(file)
+	{
+		setvbuf(mFile, nullptr, _IOFBF, BufferSize);
+	}
+
+	SvgWriter& operator<<(std::string_view str)
+	{
+		fwrite(str.data(), 1, str.size(), mFile);
+		return *this;
+	}
+
+	SvgWriter& operator<<(uint32_t value)
+	{
+		fprintf(mFile, "%u", value);
+		return *this;
+	}
+
+	// At most 2 decimals without the trailing zeros, such as 12.5 and 3.
+	SvgWriter& operator<<(double value)
+	{
+		char buffer[32];
+		int length = snprintf(buffer, sizeof(buffer), "%.2f", value);
+		while(length > 0 && buffer[length - 1] == '0')
+		{
+			--length;
+		}
+		if(length > 0 && buffer[length - 1] == '.')
+		{
+			--length;
+		}
+		if(length == 2 && buffer[0] == '-' && buffer[1] == '0')
+		{
+			length = 1; // -0
+			buffer[0] = '0';
+		}
+		fwrite(buffer, 1, length, mFile);
+		return *this;
+	}
+
+	// Write a label with the xml special chars escaped.
+	void writeText(std::string_view text)
+	{
+		for(auto const& ch : text)
+		{
+			switch(ch)
+			{
+			case '&': *this << "&amp;"; break;
+			case '<': *this << "&lt;"; break;
+			case '>': *this << "&gt;"; break;
+			case '"': *this << "&quot;"; break;
+			default: fputc(ch, mFile); break;
+			}
+		}
+	}
+
+	// Write a quoted css string in the style element, such as a font family, the quote and backslash are
+	// escaped for css, then the xml special chars, a "&quot;" would be a quote again before css reads it.
+	void writeCssString(std::string_view text)
+	{
+		fputc('"', mFile);
+		for(auto const& ch : text)
+		{
+			switch(ch)
+			{
+			case '"': *this << "\\\""; break;
+			case '\\': *this << "\\\\"; break;
+			case '&': *this << "&amp;"; break;
+			case '<': *this << "&lt;"; break;
+			case '>': *this << "&gt;"; break;
+			default: fputc(ch, mFile); break;
+			}
+		}
+		fputc('"', mFile);
+	}
+
+	// Write a css color such as "fill:#ff0000;", the opacity is written only if it is not 1.
+	void writeColor(std::string_view name, uint32_t color)
+	{
+		char buffer[16];
+		snprintf(buffer, sizeof(buffer), "#%06x;", color >> 8);
+		*this << name << ":" << std::string_view(buffer);
+		if((color & 0xff) != 0xff)
+		{
+			*this << name << "-opacity:" << (double)(color & 0xff) / 255.0 << ";";
+		}
+	}
+
+	// Write the css dash of a parsed dash array, the last unit is the offset too, as cairo draws it.
+	void writeDash(const std::vector<double>& dashArray)
+	{
+		if(dashArray.empty())
+		{
+			return;
+		}
+
+		*this << "stroke-dasharray:";
+		for(std::size_t i = 0; i < dashArray.size(); i++)
+		{
+			*this << (i > 0 ? "," : "") << dashArray[i];
+		}
+		*this << ";stroke-dashoffset:" << dashArray.back() << ";";
+	}
+
+	bool hasError() const
+	{
+		return ferror(mFile) != 0;
+	}
+
+private:
+	static constexpr std::size_t BufferSize = 1 << 16;
+	FILE* mFile;
+};
+
+constexpr int PngTileSize = 512;
+constexpr int PngSizeMax = 32767; // Max width or height of a cairo image surface.
+
+/**
+ * @brief The pixels of a png page split into tiles of PngTileSize, the last column and row may be smaller.
+ */
+struct TileGrid
+{
+	int width;
+	int height;
+	int columnCount;
+	int rowCount;
+
+	TileGrid(double pageWidth, double pageHeight, double scale)
+		: width((int)std::min(std::ceil(pageWidth * scale), (double)INT32_MAX))
+		, height((int)std::min(std::ceil(pageHeight * scale), (double)INT32_MAX))
+		, columnCount((width + PngTileSize - 1) / PngTileSize)
+		, rowCount((height + PngTileSize - 1) / PngTileSize)
+	{ }
+
+	bool isValid() const
+	{
+		return width > 0 && height > 0 && width <= PngSizeMax && height <= PngSizeMax;
+	}
+
+	int getTileCount() const
+	{
+		return columnCount * rowCount;
+	}
+
+	// Get the column or row of a pixel coordinate, the ones out of the page are clamped to it.
+	int getColumn(double x) const
+	{
+		return std::clamp((int)std::floor(x / PngTileSize), 0, columnCount - 1);
+	}
+
+	int getRow(double y) const
+	{
+		return std::clamp((int)std::floor(y / PngTileSize), 0, rowCount - 1);
+	}
+};
+
+// Check the file type by its suffix, such as ".png", ignoring the case.
+bool hasFileSuffix(const std::string& outputFile, std::string_view suffix)
+{
+	return outputFile.size() > suffix.size() &&
+		   std::equal(suffix.rbegin(), suffix.rend(), outputFile.rbegin(), [](char a, char b) {
+			   return a == std::tolower((unsigned char)b);
+		   });
+}
+
+/**
+ * @brief Render a page to a png file by tiles, each tile is drawn on its own thread into its own surface,
+ * then all the tiles are stitched to one image which is encoded to the file.
+ * 
+ * @param outputFile 	Output png file.
+ * @param tileGrid 		Tiles of the page, it should be valid.
+ * @param scale 		Pixels of one page unit.
+ * @param drawTile 		Draw a tile by a context in page units, only the nodes in the rectangle are needed.
+ * @return true 		Pass.
+ * @return false 		A tile or the file is not written.
+ */
+bool writeTiledPng(const std::string& outputFile,
+				   const TileGrid& tileGrid,
+				   double scale,
+				   const std::function<void(const Cairo::RefPtr<Cairo::Context>&, int, const PageRect&)>& drawTile)
+{
+	BiTreeAssert(tileGrid.isValid());
+	auto const width = tileGrid.width;
+	auto const height = tileGrid.height;
+
+	try
+	{
+		auto image = Cairo::ImageSurface::create(Cairo::Surface::Format::ARGB32, width, height);
+		auto const imageStride = image->get_stride();
+		auto const imageData = image->get_data();
+
+		auto const columnCount = tileGrid.columnCount;
+		auto const tileCount = tileGrid.getTileCount();
+		std::atomic<int> nextTile{0};
+		std::atomic<bool> isFailed{false};
+
+		// Each tile is copied to its own area of the image, so the threads never write the same bytes.
+		auto renderTiles = [&]() {
+			for(int tile = nextTile++; tile < tileCount && !isFailed; tile = nextTile++)
+			try
+			{
+				auto const tileX = (tile % columnCount) * PngTileSize;
+				auto const tileY = (tile / columnCount) * PngTileSize;
+				auto const tileWidth = std::min(PngTileSize, width - tileX);
+				auto const tileHeight = std::min(PngTileSize, height - tileY);
+
+				auto surface = Cairo::ImageSurface::create(Cairo::Surface::Format::ARGB32, tileWidth, tileHeight);
+				auto cr = Cairo::Context::create(surface);
+				cr->translate(-tileX, -tileY);
+				cr->scale(scale, scale);
+				drawTile(cr,
+						 tile,
+						 {tileX / scale, tileY / scale, (tileX + tileWidth) / scale, (tileY + tileHeight) / scale});
+				surface->flush();
+
+				auto const tileStride = surface->get_stride();
+				auto const tileData = surface->get_data();
+				for(int row = 0; row < tileHeight; row++)
+				{
+					std::copy_n(tileData + (std::size_t)row * tileStride,
+								(std::size_t)tileWidth * 4,
+								imageData + (std::size_t)(tileY + row) * imageStride + (std::size_t)tileX * 4);
+				}
+			}
+			catch(...)
+			{
+				isFailed = true;
+			}
+		};
+
+		auto threadCount = std::min((int)std::max(1u, std::thread::hardware_concurrency()), tileCount);
+		std::vector<std::thread> threadArray;
+		for(int i = 1; i < threadCount; i++)
+		{
+			threadArray.emplace_back(renderTiles);
+		}
+		renderTiles();
+		for(auto& thread : threadArray)
+		{
+			thread.join();
+		}
+		if(isFailed)
+		{
+			PrintError("Rendering png tiles failed.\n");
+			return false;
+		}
+
+		image->mark_dirty();
+		image->write_to_png(outputFile);
+	}
+	catch(...)
+	{
+		PrintError("The output file may be locked or incorrect, writing png failed.\n");
+		return false;
+	}
+
+	return true;
+}
+} // namespace
+
 BiTreeRenderer::BiTreeRenderer() { }
 
 BiTreeRenderer::~BiTreeRenderer() { }
 
-double BiTreeRenderer::getBestRadius(const std::size_t& strLen)
+bool BiTreeRenderer::drawSvg(const BiTreeLayouter::LayoutInfo& layoutInfo, const std::string& outputFile)
+{
+	BiTreeAssert(layoutInfo.labelPool != nullptr);
+	BiTreeAssert(!layoutInfo.styleArray.empty());
+	BiTreeAssert(layoutInfo.nodeStyleArray.size() == layoutInfo.bitreeNodeArray.size());
+
+	FILE* file = fopen(outputFile.c_str(), "wb");
+	if(file == nullptr)
+	{
+		PrintError("The output file may be locked or incorrect, open [%s] failed.\n", outputFile.c_str());
+		return false;
+	}
+
+	PrintInfo("Rendering bitree..........................\n");
+	SvgWriter svg(file);
+	auto const& styleArray = layoutInfo.styleArray;
+	auto const& nodeArray = layoutInfo.bitreeNodeArray;
+	auto const& nodeStyleArray = layoutInfo.nodeStyleArray;
+
+	// The styles are interned, so each used style is one css class for the edges, circles and texts:
+	// .e<id> for the edge to the parent, .c<id> for the circle and .t<id> for the label.
+	std::vector<bool> styleUsedArray(styleArray.size(), false);
+	for(auto const& styleIndex : nodeStyleArray)
+	{
+		styleUsedArray[styleIndex] = true;
+	}
+
+	svg << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+		<< "<svg xmlns=\"http://www.w3.org/2000/svg\" width=\"" << layoutInfo.pageWidth << "pt\" height=\""
+		<< layoutInfo.pageheight << "pt\" viewBox=\"0 0 " << layoutInfo.pageWidth << " "
+		<< layoutInfo.pageheight << "\">\n<style>\n"
+		<< "path{fill:none}text{text-anchor:middle;dominant-baseline:central;white-space:pre}\n";
+	for(uint32_t i = 0; i < styleArray.size(); i++)
+	{
+		if(!styleUsedArray[i])
+		{
+			continue;
+		}
+
+		auto const& base = styleArray[i].nodeBaseProperty;
+		auto const& extend = styleArray[i].nodeExtendProperty;
+		svg << ".e" << i << "{";
+		svg.writeColor("stroke", base.edgeColor);
+		svg << "stroke-width:" << base.edgeWidth << ";";
+		svg.writeDash(BiTreePropertyManager::getDash(base.edgeDashId));
+		svg << "}.c" << i << "{";
+		svg.writeColor("fill", base.fillColor);
+		svg.writeColor("stroke", base.borderColor);
+		svg << "stroke-width:" << base.borderWidth << ";";
+		svg.writeDash(BiTreePropertyManager::getDash(base.borderDashId));
+		svg << "}.t" << i << "{";
+		svg.writeColor("fill", base.fontColor);
+		svg << "font-size:" << extend.fontSize << "px;";
+		// An empty family is the default of cairo's toy font api, which is sans-serif.
+		if(extend.fontFamily.empty())
+		{
+			svg << "font-family:sans-serif;";
+		}
+		else
+		{
+			svg << "font-family:";
+			svg.writeCssString(extend.fontFamily);
+			svg << ";";
+		}
+		svg << (extend.fontSlant != 0 ? "font-style:italic;" : "")
+			<< (extend.fontWeight != 0 ? "font-weight:bold;" : "") << "}\n";
+	}
+	svg << "</style>\n<rect width=\"100%\" height=\"100%\" style=\"";
+	svg.writeColor("fill", styleArray[0].nodeExtendProperty.pageBackgroundColor);
+	svg << "\"/>\n";
+
+	auto getPos = [&](const BiTreeParser::BiTreeNode* node) {
+		return pos_t(layoutInfo.toAbsoluteX(node->x), layoutInfo.toAbsoluteY(node->y));
+	};
+
+	auto getRadius = [&](const BiTreePropertyManager::NodeProperty& nodeProperty) {
+		return nodeProperty.nodeBaseProperty.nodeRadius > 0
+				   ? ((double)(nodeProperty.nodeBaseProperty.nodeRadius))
+				   : (layoutInfo.raduis);
+	};
+
+	// Each node is written as it is visited, all the edges first, then the circles over them, then the texts,
+	// as the pdf is drawn. Nothing is kept but the writer's buffer.
+	for(std::size_t i = 0; i < nodeArray.size(); i++)
+	{
+		auto const node = nodeArray[i];
+		if(node->parent == nullptr)
+		{
+			continue;
+		}
+
+		bool status = false;
+		const uint32_t radius = getRadius(styleArray[nodeStyleArray[i]]);
+		vec2d_t vec2d = getClippedEdge(getPos(node), getPos(node->parent), radius, status);
+		if(status)
+		{
+			svg << "<path class=\"e" << nodeStyleArray[i] << "\" d=\"M" << vec2d.p1.x << " " << vec2d.p1.y
+				<< "L" << vec2d.p2.x << " " << vec2d.p2.y << "\"/>\n";
+		}
+	}
+
+	for(std::size_t i = 0; i < nodeArray.size(); i++)
+	{
+		auto pos = getPos(nodeArray[i]);
+		svg << "<circle class=\"c" << nodeStyleArray[i] << "\" cx=\"" << pos.x << "\" cy=\"" << pos.y
+			<< "\" r=\"" << getRadius(styleArray[nodeStyleArray[i]]) << "\"/>\n";
+	}
+
+	for(std::size_t i = 0; i < nodeArray.size(); i++)
+	{
+		auto const& nodeLabelProperty = styleArray[nodeStyleArray[i]].nodeBaseProperty.nodeLabel;
+		auto const text = nodeLabelProperty.empty() ? layoutInfo.labelPool->get(nodeArray[i]->labelId)
+													: std::string_view(nodeLabelProperty);
+		if(text.empty())
+		{
+			continue;
+		}
+
+		auto pos = getPos(nodeArray[i]);
+		svg << "<text class=\"t" << nodeStyleArray[i] << "\" x=\"" << pos.x << "\" y=\"" << pos.y << "\">";
+		svg.writeText(text);
+		svg << "</text>\n";
+	}
+	svg << "</svg>\n";
+
+	bool status = !svg.hasError();
+	if(fclose(file) != 0 || !status)
+	{
+		PrintError("Writing svg [%s] failed.\n", outputFile.c_str());
+		return false;
+	}
+	PrintInfo("Rendering bitree..........................ok\n\n");
+	PrintInfo("Output: [%s]\n", outputFile.c_str());
+
+	return true;
+}
+
+void BiTreeRenderer::setDpi(const uint32_t& dpi)
+{
+	BiTreeAssert(dpi >= PngDpiMin && dpi <= PngDpiMax);
+	mDpi = dpi;
+}
+
+double BiTreeRenderer::getBestRadius(const std::size_t& strLen,
+									 const BiTreePropertyManager& propertyManager)
 {
 	auto surface = Cairo::ImageSurface::create(Cairo::Surface::Format::ARGB32, 20, 20);
 	auto cr = Cairo::Context::create(surface);
@@ -40,17 +576,18 @@ double BiTreeRenderer::getBestRadius(const std::size_t& strLen)
 	std::string text;
 	text.assign(strLen, 'A');
 
-	auto& currentProperty = BiTreePropertyManager::getCurrentProperty();
-	if(!currentProperty.nodeExtendProperty.fontFamily.empty())
-	{
-		cr->select_font_face(
-			currentProperty.nodeExtendProperty.fontFamily,
-			(Cairo::ToyFontFace::Slant)currentProperty.nodeExtendProperty.fontSlant,
-			(Cairo::ToyFontFace::Weight)currentProperty.nodeExtendProperty.fontWeight);
-	}
+	// The slant and weight only take effect with a font family here.
+	auto& nodeExtendProperty = propertyManager.getCurrentProperty().nodeExtendProperty;
+	bool hasFontFamily = !nodeExtendProperty.fontFamily.empty();
+	auto font = TextCache::getFont(TextCache::Metrics::Layout,
+								   nodeExtendProperty.fontFamily,
+								   hasFontFamily ? nodeExtendProperty.fontSlant : 0,
+								   hasFontFamily ? nodeExtendProperty.fontWeight : 0,
+								   nodeExtendProperty.fontSize);
 
-	cr->set_font_size((double)currentProperty.nodeExtendProperty.fontSize);
-	cr->get_text_extents(text, extents);
+	cr->set_font_face(font->fontFace);
+	cr->set_font_size((double)nodeExtendProperty.fontSize);
+	TextCache::getTextExtents(cr, font, text, extents);
 
 	return (extents.width / 2 + extents.x_bearing);
 }
@@ -114,300 +651,518 @@ BiTreeRenderer::vec2d_t BiTreeRenderer::getClippedEdge(const BiTreeRenderer::pos
 	return vec2d;
 }
 
-bool BiTreeRenderer::convertDashStringToCairoDash(const std::string& nodeDashStr,
-												  std::vector<double>& dashes,
-												  double& offset)
+bool BiTreeRenderer::draw(const BiTreeLayouter::LayoutInfo& layoutInfo,
+						  const std::string& outputFile)
 {
-	bool status = false;
-	dashes.clear();
-	offset = 0;
-
-	if(nodeDashStr.empty())
+	if(hasFileSuffix(outputFile, ".svg"))
 	{
-		return status;
+		return drawSvg(layoutInfo, outputFile);
 	}
 
-	auto skipSpace = [](std::string::const_iterator begin, std::string::const_iterator end) {
-		while(begin < end && (*begin == ' ' || *begin == '\t' || *begin == '"' || *begin == ';' ||
-							  *begin == ',' || *begin == '|' || *begin == ':'))
+	const double gRadius = layoutInfo.raduis;
+	const bool isPng = hasFileSuffix(outputFile, ".png");
+	std::shared_ptr<Cairo::PdfSurface> surface;
+
+	try
+	{
+		if(outputFile == "-")
 		{
-			++begin;
+			// Write to stdout, for pipelines.
+#ifdef _WIN32
+			_setmode(_fileno(stdout), _O_BINARY);
+#endif
+			surface = Cairo::PdfSurface::create_for_stream(
+				[](const unsigned char* data, unsigned int length) {
+					return fwrite(data, 1, length, stdout) == length ? CAIRO_STATUS_SUCCESS
+																	 : CAIRO_STATUS_WRITE_ERROR;
+				},
+				layoutInfo.pageWidth,
+				layoutInfo.pageheight);
 		}
-		return begin;
-	};
-
-	auto getNextDigit = [&](std::string::const_iterator begin,
-							std::string::const_iterator end,
-							double& value,
-							bool& status) {
-		std::string str;
-		status = false;
-		value = 0.0f;
-
-		begin = skipSpace(begin, end);
-		if(begin < end && (begin + 1) < end && *begin == '0' &&
-		   (*(begin + 1) == 'x' || *(begin + 1) == 'X'))
+		else if(!isPng) // The png surfaces are created by writeTiledPng.
 		{
-			str.push_back(*begin);
-			str.push_back(*(begin + 1));
-			begin += 2;
+			surface =
+				Cairo::PdfSurface::create(outputFile, layoutInfo.pageWidth, layoutInfo.pageheight);
 		}
+	}
+	catch(...)
+	{
+		PrintError("Dump parameter-----------------------------------------------------------\n");
+		PrintError("  ofile: %s\n", outputFile.c_str());
+		PrintError("  width: %f\n", layoutInfo.pageWidth);
+		PrintError("  height: %f\n", layoutInfo.pageheight);
+		PrintError("The output file may be locked or incorrect, Cairo PdfSurface create failed.\n");
+		return false;
+	}
 
-		while(begin < end && '0' <= (*begin) && (*begin) <= '9')
+	BiTreeAssert(layoutInfo.labelPool != nullptr);
+	BiTreeAssert(!layoutInfo.styleArray.empty());
+	BiTreeAssert(layoutInfo.nodeStyleArray.size() == layoutInfo.bitreeNodeArray.size());
+	auto const& labelPool = *layoutInfo.labelPool;
+
+	// Group the nodes by style, so each style is set up once for all its nodes.
+	// The nodes of style i are styleNodeArray[styleNodeOffsetArray[i], styleNodeOffsetArray[i+1]).
+	auto const styleSize = layoutInfo.styleArray.size();
+	auto const nodeSize = layoutInfo.bitreeNodeArray.size();
+	std::vector<uint32_t> styleNodeOffsetArray(styleSize + 1, 0);
+	std::vector<uint32_t> styleNodeArray(nodeSize);
+	for(auto const& styleIndex : layoutInfo.nodeStyleArray)
+	{
+		++styleNodeOffsetArray[styleIndex + 1];
+	}
+	for(std::size_t i = 0; i < styleSize; i++)
+	{
+		styleNodeOffsetArray[i + 1] += styleNodeOffsetArray[i];
+	}
+	{
+		auto nextArray = styleNodeOffsetArray;
+		for(uint32_t i = 0; i < nodeSize; i++)
 		{
-			str.push_back(*begin);
-			++begin;
+			styleNodeArray[nextArray[layoutInfo.nodeStyleArray[i]]++] = i;
 		}
+	}
+
+	using NodeProperty = BiTreePropertyManager::NodeProperty;
 
-		if(!str.empty())
+	auto getPos = [&](const BiTreeParser::BiTreeNode* node) {
+		return pos_t(layoutInfo.toAbsoluteX(node->x), layoutInfo.toAbsoluteY(node->y));
+	};
+
+	auto getRadius = [&](const NodeProperty& nodeProperty) {
+		return nodeProperty.nodeBaseProperty.nodeRadius > 0
+				   ? ((double)(nodeProperty.nodeBaseProperty.nodeRadius))
+				   : (gRadius);
+	};
+
+	// Styles with the same drawing parameters are drawn as one group, such as the styles only differ
+	// in FillColor share the path of their edges, each group is one save() and restore().
+	// The group index of each style, in the order of the styles first used, UINT32_MAX for unused styles.
+	auto groupStyles = [&](auto getKey) {
+		std::map<decltype(getKey(layoutInfo.styleArray[0])), uint32_t> groupIndexMap;
+		std::vector<uint32_t> styleGroupArray(styleSize, UINT32_MAX);
+		for(uint32_t i = 0; i < styleSize; i++)
 		{
-			auto data = std::stoul(str, nullptr, 0);
-			if(0 < data && data <= 0xff)
+			if(styleNodeOffsetArray[i] < styleNodeOffsetArray[i + 1])
 			{
-				value = (double)data;
-				status = true;
-
-				return begin;
+				auto result = groupIndexMap.emplace(getKey(layoutInfo.styleArray[i]), (uint32_t)groupIndexMap.size());
+				styleGroupArray[i] = result.first->second;
 			}
 		}
 
-		return begin;
+		return styleGroupArray;
 	};
 
-	auto begin = nodeDashStr.begin();
-	auto end = nodeDashStr.end();
-	dashes.clear();
-	double value = 0.0f;
-	while(begin < end)
+	auto const edgeStyleGroupArray = groupStyles([](const NodeProperty& nodeProperty) {
+		auto const& base = nodeProperty.nodeBaseProperty;
+		return std::make_tuple(base.edgeColor, base.edgeWidth, base.edgeDash);
+	});
+	auto const circleStyleGroupArray = groupStyles([](const NodeProperty& nodeProperty) {
+		auto const& base = nodeProperty.nodeBaseProperty;
+		return std::make_tuple(base.fillColor, base.borderColor, base.borderWidth, base.borderDash);
+	});
+	auto const textStyleGroupArray = groupStyles([](const NodeProperty& nodeProperty) {
+		auto const& extend = nodeProperty.nodeExtendProperty;
+		return std::make_tuple(nodeProperty.nodeBaseProperty.fontColor,
+							   extend.fontFamily,
+							   extend.fontSlant,
+							   extend.fontWeight,
+							   extend.fontSize);
+	});
+
+	// The nodes of one style in [begin, end), the runs of one group are adjacent.
+	struct StyleRun
 	{
-		begin = skipSpace(begin, end);
-		begin = getNextDigit(begin, end, value, status);
-		if(status)
-		{
-			dashes.push_back(value);
-		}
-		else
+		uint32_t group;
+		const uint32_t* begin;
+		const uint32_t* end;
+	};
+
+	// Split the node indices sorted by style into runs, then order them by group,
+	// the runs of a group keep the order of their styles.
+	auto makeRuns = [&](const std::vector<uint32_t>& styleGroupArray, const uint32_t* begin, const uint32_t* end) {
+		std::vector<StyleRun> runArray;
+		while(begin < end)
 		{
-			break;
+			auto const styleIndex = layoutInfo.nodeStyleArray[*begin];
+			auto runEnd = begin + 1;
+			while(runEnd < end && layoutInfo.nodeStyleArray[*runEnd] == styleIndex)
+			{
+				++runEnd;
+			}
+			runArray.push_back({styleGroupArray[styleIndex], begin, runEnd});
+			begin = runEnd;
 		}
-	}
-
-	if(dashes.size() >= 2)
-	{
-		offset = dashes.back();
-		return true;
-	}
-
-	return false;
-}
+		std::stable_sort(runArray.begin(), runArray.end(), [](const StyleRun& a, const StyleRun& b) {
+			return a.group < b.group;
+		});
 
-bool BiTreeRenderer::draw(const NodeInfoArray* nodeInfoArray,
-						  const BiTreeLayouter::LayoutInfo& layoutInfo,
-						  const std::string& outputFile)
-{
-	const double gRadius = layoutInfo.raduis;
-	Cairo::TextExtents extents;
-	std::shared_ptr<Cairo::PdfSurface> surface;
-	std::vector<double> dashes;
-	double dashOffset = 0.0f;
+		return runArray;
+	};
 
-	try
+	// The runs of all the passes of a page or a tile.
+	struct PageRuns
 	{
-		surface =
-			Cairo::PdfSurface::create(outputFile, layoutInfo.pageWidth, layoutInfo.pageheight);
-	}
-	catch(...)
-	{
-		PrintError("Dump parameter-----------------------------------------------------------\n");
-		PrintError("  ofile: %s\n", outputFile.c_str());
-		PrintError("  width: %f\n", layoutInfo.pageWidth);
-		PrintError("  height: %f\n", layoutInfo.pageheight);
-		PrintError("The output file may be locked or incorrect, Cairo PdfSurface create failed.\n");
-		return false;
-	}
+		std::vector<StyleRun> edgeRunArray;
+		std::vector<StyleRun> circleRunArray;
+		std::vector<StyleRun> textRunArray;
+	};
+
+	auto makePageRuns = [&](const uint32_t* begin, const uint32_t* end) {
+		return PageRuns{makeRuns(edgeStyleGroupArray, begin, end),
+						makeRuns(circleStyleGroupArray, begin, end),
+						makeRuns(textStyleGroupArray, begin, end)};
+	};
 
-	auto getThisNodeProperty = [&](BiTreeParser::BiTreeNode* node) {
-		if(node->isDataDecimalOrHexNumber())// Only using digits-number as index to NodeInfo.
+	// Call visit for each node of the runs of a group with the node's style and index.
+	auto forEachNode = [&](const StyleRun* runBegin, const StyleRun* runEnd, auto visit) {
+		for(auto run = runBegin; run < runEnd; ++run)
 		{
-			auto& nodeInfo = nodeInfoArray->findNodeInfo(node->data);
-			if(!nodeInfo.empty()) // Find the NodeInfo pass
+			auto const& nodeProperty = layoutInfo.styleArray[layoutInfo.nodeStyleArray[*run->begin]];
+			for(auto it = run->begin; it < run->end; ++it)
 			{
-				// Convert NodeInfo to its data-structure of properties.
-				return BiTreePropertyManager::getCurrentPropertyByUpdate(nodeInfo);
+				visit(nodeProperty, layoutInfo.bitreeNodeArray[*it], *it);
 			}
 		}
+	};
 
-		// Return default data-structure of properties.
-		return BiTreePropertyManager::getCurrentProperty();
+	auto getGroupProperty = [&](const StyleRun* runBegin) -> const NodeProperty& {
+		return layoutInfo.styleArray[layoutInfo.nodeStyleArray[*runBegin->begin]];
 	};
 
-	auto drawPageBackgroundColor = [&](const uint32_t& pageBackgroundColor) {
-		auto cr = Cairo::Context::create(surface);
-		cr->set_source_rgba(red(pageBackgroundColor),
-							green(pageBackgroundColor),
-							blue(pageBackgroundColor),
-							alpha(pageBackgroundColor));
-		cr->paint();
+	// Get the label drawn for a node, nodeLabel keeps the string of a label in labelPool.
+	auto getText = [&](const NodeProperty& nodeProperty,
+					   const BiTreeParser::BiTreeNode* node,
+					   std::string& nodeLabel) -> const std::string& {
+		auto const& nodeLabelProperty = nodeProperty.nodeBaseProperty.nodeLabel;
+		if(!nodeLabelProperty.empty())
+		{
+			return nodeLabelProperty;
+		}
+		nodeLabel.assign(labelPool.get(node->labelId));
+		return nodeLabel;
 	};
 
-	auto drawCircle = [&](const pos_t& pos,
-						  const double& radius,
-						  const uint32_t& borderColor,
-						  uint32_t& borderWidth,
-						  const uint32_t& fillColor,
-						  const std::string& borderDashStr) {
-		auto cr = Cairo::Context::create(surface);
+	auto getFont = [&](const NodeProperty& nodeProperty, TextCache::Metrics metrics, double scale) {
+		auto const& nodeExtendProperty = nodeProperty.nodeExtendProperty;
+		return TextCache::getFont(metrics,
+								  nodeExtendProperty.fontFamily,
+								  nodeExtendProperty.fontSlant,
+								  nodeExtendProperty.fontWeight,
+								  nodeExtendProperty.fontSize,
+								  scale);
+	};
 
-		cr->arc(pos.x, pos.y, radius, 0.0, Angle360);
-		cr->set_source_rgba(red(fillColor), green(fillColor), blue(fillColor), alpha(fillColor));
-		cr->fill();
+	// Get the start position of a text centered at pos.
+	auto getTextPos = [](const pos_t& pos, const Cairo::TextExtents& extents) {
+		return pos_t(pos.x - (extents.width / 2 + extents.x_bearing), pos.y - (extents.height / 2 + extents.y_bearing));
+	};
 
-		if(!borderDashStr.empty())
-		{
-			if(convertDashStringToCairoDash(borderDashStr, dashes, dashOffset))
+	// A measured text, its start position and its ink rectangle.
+	struct TextBox
+	{
+		pos_t pos;
+		PageRect rect;
+	};
+
+	// Draw the page or a tile of it by cr, it is called once for a pdf, or by each tile of a png at the same time.
+	// One context for the whole page, the state set up for a group is saved and restored around it,
+	// so a group never sees the dash or font of the previous one.
+	// If pageRect is not nullptr, the nodes out of it are skipped.
+	// If textBoxArray is not nullptr, it is the measured text of each node, or the texts are measured here.
+	auto drawPage = [&](const Cairo::RefPtr<Cairo::Context>& cr,
+						const PageRuns& pageRuns,
+						TextCache::Metrics metrics,
+						double scale,
+						const PageRect* pageRect,
+						const std::vector<TextBox>* textBoxArray) {
+		Cairo::TextExtents extents;
+		std::string nodeLabel; // Reused for each node label in labelPool.
+
+		auto isOutside = [&](double left, double top, double right, double bottom) {
+			return pageRect != nullptr && pageRect->isOutside(left, top, right, bottom);
+		};
+
+		auto setColor = [&](const uint32_t& color) {
+			cr->set_source_rgba(red(color), green(color), blue(color), alpha(color));
+		};
+
+		// The dash units are checked and parsed when the property is set, the last unit is the offset too.
+		auto setDash = [&](const std::vector<double>& dashArray) {
+			if(!dashArray.empty())
 			{
-				cr->set_dash(dashes, dashOffset);
+				cr->set_dash(dashArray, dashArray.back());
 			}
-			else
+		};
+
+		auto drawPageBackgroundColor = [&](const uint32_t& pageBackgroundColor) {
+			cr->save();
+			setColor(pageBackgroundColor);
+			cr->paint();
+			cr->restore();
+		};
+
+		// Draw the edges of a group as one path.
+		auto drawEdges = [&](const StyleRun* runBegin, const StyleRun* runEnd) {
+			bool hasEdge = false; // The root has no edge.
+			forEachNode(runBegin, runEnd, [&](const NodeProperty& nodeProperty, const BiTreeParser::BiTreeNode* node, uint32_t) {
+				if(node->parent == nullptr)
+				{
+					return;
+				}
+
+				bool status = false;
+				const uint32_t radius = getRadius(nodeProperty);
+				vec2d_t vec2d = getClippedEdge(getPos(node), getPos(node->parent), radius, status);
+				double margin = nodeProperty.nodeBaseProperty.edgeWidth;
+				if(status && !isOutside(std::min(vec2d.p1.x, vec2d.p2.x) - margin,
+										std::min(vec2d.p1.y, vec2d.p2.y) - margin,
+										std::max(vec2d.p1.x, vec2d.p2.x) + margin,
+										std::max(vec2d.p1.y, vec2d.p2.y) + margin))
+				{
+					hasEdge = true;
+					cr->move_to(vec2d.p1.x, vec2d.p1.y);
+					cr->line_to(vec2d.p2.x, vec2d.p2.y);
+				}
+			});
+
+			if(hasEdge)
 			{
-				PrintError("BorderDash value: [%s] may be invalid, it is not used.\n",
-						   borderDashStr.c_str());
+				auto const& nodeBaseProperty = getGroupProperty(runBegin).nodeBaseProperty;
+				setColor(nodeBaseProperty.edgeColor);
+				cr->set_line_width((double)nodeBaseProperty.edgeWidth);
+				setDash(BiTreePropertyManager::getDash(nodeBaseProperty.edgeDashId));
+				cr->stroke();
 			}
-		}
+		};
+
+		// Fill then stroke the circles of a group as one path.
+		auto drawCircles = [&](const StyleRun* runBegin, const StyleRun* runEnd) {
+			bool hasCircle = false;
+			forEachNode(runBegin, runEnd, [&](const NodeProperty& nodeProperty, const BiTreeParser::BiTreeNode* node, uint32_t) {
+				auto pos = getPos(node);
+				auto radius = getRadius(nodeProperty);
+				double margin = radius + nodeProperty.nodeBaseProperty.borderWidth;
+				if(!isOutside(pos.x - margin, pos.y - margin, pos.x + margin, pos.y + margin))
+				{
+					hasCircle = true;
+					cr->begin_new_sub_path();
+					cr->arc(pos.x, pos.y, radius, 0.0, Angle360);
+				}
+			});
 
-		cr->set_source_rgba(
-			red(borderColor), green(borderColor), blue(borderColor), alpha(borderColor));
-		cr->set_line_width(double(borderWidth));
-		cr->arc(pos.x, pos.y, radius, 0.0, Angle360);
+			if(hasCircle)
+			{
+				auto const& nodeBaseProperty = getGroupProperty(runBegin).nodeBaseProperty;
+				setColor(nodeBaseProperty.fillColor);
+				cr->fill_preserve();
+
+				setDash(BiTreePropertyManager::getDash(nodeBaseProperty.borderDashId));
+				setColor(nodeBaseProperty.borderColor);
+				cr->set_line_width(double(nodeBaseProperty.borderWidth));
+				cr->stroke();
+			}
+		};
 
-		cr->stroke();
-	};
+		// Draw the texts of a group by one font.
+		auto drawTexts = [&](const StyleRun* runBegin, const StyleRun* runEnd) {
+			auto const& nodeProperty = getGroupProperty(runBegin);
 
-	auto drawText = [&](const pos_t& pos,
-						const std::string& text,
-						const std::string& fontFamily,
-						uint32_t fontSlant,
-						uint32_t fontWeight,
-						uint32_t fontSize,
-						uint32_t fontColor) {
-		if(!text.empty())
-		{
-			auto cr = Cairo::Context::create(surface);
-
-			cr->set_source_rgba(
-				red(fontColor), green(fontColor), blue(fontColor), alpha(fontColor));
-			cr->set_font_size((double)fontSize);
-
-			auto font = Cairo::ToyFontFace::create(fontFamily,
-												   (Cairo::ToyFontFace::Slant)fontSlant,
-												   (Cairo::ToyFontFace::Weight)fontWeight);
-			cr->set_font_face(font);
-
-			// Get center drawing position.
-			cr->get_text_extents(text, extents);
-			auto newX = pos.x - (extents.width / 2 + extents.x_bearing);
-			auto newY = pos.y - (extents.height / 2 + extents.y_bearing);
-			cr->move_to(newX, newY);
-			
-			cr->show_text(text);
-		}
-	};
+			setColor(nodeProperty.nodeBaseProperty.fontColor);
+			cr->set_font_size((double)nodeProperty.nodeExtendProperty.fontSize);
 
-	auto drawEdge = [&](const pos_t& childPos,
-						const pos_t& parentPos,
-						const uint32_t radius,
-						uint32_t& edgeWidth,
-						const uint32_t& edgeColor,
-						const std::string& edgeDashStr) {
-		bool status = false;
-		vec2d_t vec2d = getClippedEdge(childPos, parentPos, radius, status);
+			auto font = getFont(nodeProperty, metrics, scale);
+			cr->set_font_face(font->fontFace);
 
-		if(status)
-		{
-			auto cr = Cairo::Context::create(surface);
-			cr->move_to(vec2d.p1.x, vec2d.p1.y);
-			cr->set_source_rgba(
-				red(edgeColor), green(edgeColor), blue(edgeColor), alpha(edgeColor));
-			cr->set_line_width((double)edgeWidth);
+			forEachNode(runBegin, runEnd, [&](const NodeProperty& nodeProperty, const BiTreeParser::BiTreeNode* node, uint32_t index) {
+				auto const& text = getText(nodeProperty, node, nodeLabel);
+				if(text.empty())
+				{
+					return;
+				}
 
-			if(!edgeDashStr.empty())
-			{
-				if(convertDashStringToCairoDash(edgeDashStr, dashes, dashOffset))
+				// Get center drawing position.
+				pos_t textPos;
+				if(textBoxArray != nullptr)
 				{
-					cr->set_dash(dashes, dashOffset);
+					auto const& textBox = (*textBoxArray)[index];
+					if(isOutside(textBox.rect.x0, textBox.rect.y0, textBox.rect.x1, textBox.rect.y1))
+					{
+						return;
+					}
+					textPos = textBox.pos;
 				}
 				else
 				{
-					PrintError("EdgeDash value: [%s] may be invalid, it is not used.\n",
-							   edgeDashStr.c_str());
+					TextCache::getTextExtents(cr, font, text, extents);
+					textPos = getTextPos(getPos(node), extents);
+				}
+				cr->move_to(textPos.x, textPos.y);
+
+				cr->show_text(text);
+			});
+		};
+
+		// Call draw for the runs of each group, the state of the group is dropped after it.
+		auto drawByGroup = [&](const std::vector<StyleRun>& runArray,
+							   const std::function<void(const StyleRun*, const StyleRun*)>& draw) {
+			auto runEnd = runArray.data() + runArray.size();
+			for(auto runBegin = runArray.data(); runBegin < runEnd;)
+			{
+				auto groupEnd = runBegin + 1;
+				while(groupEnd < runEnd && groupEnd->group == runBegin->group)
+				{
+					++groupEnd;
 				}
+
+				cr->save();
+				draw(runBegin, groupEnd);
+				cr->restore();
+				runBegin = groupEnd;
 			}
+		};
 
-			cr->line_to(vec2d.p2.x, vec2d.p2.y);
-			cr->stroke();
-		}
-	};
+		// 000, draw page background.
+		drawPageBackgroundColor(layoutInfo.styleArray[0].nodeExtendProperty.pageBackgroundColor);
 
-	auto showPage = [&]() {
-		auto cr = Cairo::Context::create(surface);
-		cr->show_page();
+		// 001, draw the bitree's nodes, all the edges first, then the circles over them, then the texts.
+		drawByGroup(pageRuns.edgeRunArray, drawEdges);
+		drawByGroup(pageRuns.circleRunArray, drawCircles);
+		drawByGroup(pageRuns.textRunArray, drawTexts);
 	};
 
 	PrintInfo("Rendering bitree..........................\n");
 
-	// 000, draw page background.
-	auto const& pageBackgroundColor =
-		BiTreePropertyManager::getCurrentProperty().nodeExtendProperty.pageBackgroundColor;
-	drawPageBackgroundColor(pageBackgroundColor);
-
-	// 001, draw the bitree's nodes.
-	for(auto const& node : layoutInfo.bitreeNodeArray)
-	{
-		//auto& nodeProperty = getThisNodeProperty(node); cannot work with mingwXX compiler.
-		auto nodeProperty = getThisNodeProperty(node);
-
-		const pos_t childPos(layoutInfo.toAbsoluteX(node->x), layoutInfo.toAbsoluteY(node->y));
-
-		auto currentRadius = nodeProperty.nodeBaseProperty.nodeRadius > 0
-								 ? ((double)(nodeProperty.nodeBaseProperty.nodeRadius))
-								 : (gRadius);
-
-		// 002-1, draw edge.
-		if(node->parent != nullptr)
-		{
-			const pos_t parentPos(layoutInfo.toAbsoluteX(node->parent->x), layoutInfo.toAbsoluteY(node->parent->y));
-			bool status = false;
-			drawEdge(childPos,
-					 parentPos,
-					 currentRadius,
-					 nodeProperty.nodeBaseProperty.edgeWidth,
-					 nodeProperty.nodeBaseProperty.edgeColor,
-					 nodeProperty.nodeBaseProperty.edgeDash);
-		}
-
-		// 002-2, draw circle.
-		drawCircle(childPos,
-				   currentRadius,
-				   nodeProperty.nodeBaseProperty.borderColor,
-				   nodeProperty.nodeBaseProperty.borderWidth,
-				   nodeProperty.nodeBaseProperty.fillColor,
-				   nodeProperty.nodeBaseProperty.borderDash);
-
-		// 002-3, draw text.
-		std::string nodeLabel = (nodeProperty.nodeBaseProperty.nodeLabel.empty()
-									 ? (*node).data
-									 : nodeProperty.nodeBaseProperty.nodeLabel);
-		drawText(childPos,
-				 nodeLabel,
-				 nodeProperty.nodeExtendProperty.fontFamily,
-				 nodeProperty.nodeExtendProperty.fontSlant,
-				 nodeProperty.nodeExtendProperty.fontWeight,
-				 nodeProperty.nodeExtendProperty.fontSize,
-				 nodeProperty.nodeBaseProperty.fontColor);
-	} // Drawing things end.
-
-	// 003, get result.
-	showPage();
+	auto const pageRuns = makePageRuns(styleNodeArray.data(), styleNodeArray.data() + nodeSize);
+	if(isPng)
+	{
+		auto const scale = mDpi / 72.0; // A page unit is 1/72 inch.
+		TileGrid tileGrid(layoutInfo.pageWidth, layoutInfo.pageheight, scale);
+		if(!tileGrid.isValid())
+		{
+			PrintError("The png size %dx%d is out of [1, %d], a lower dpi may be used.\n",
+					   tileGrid.width,
+					   tileGrid.height,
+					   PngSizeMax);
+			return false;
+		}
+
+		// Measure the texts once before the tiles, so the tiles do not measure them again.
+		// The bounding rectangle of each node covers its edge to the parent, circle and text.
+		std::vector<TextBox> textBoxArray(nodeSize);
+		std::vector<PageRect> nodeRectArray(nodeSize);
+		for(uint32_t i = 0; i < nodeSize; i++)
+		{
+			auto const node = layoutInfo.bitreeNodeArray[i];
+			auto const& nodeBaseProperty = layoutInfo.styleArray[layoutInfo.nodeStyleArray[i]].nodeBaseProperty;
+			auto const pos = getPos(node);
+			auto const margin = getRadius(layoutInfo.styleArray[layoutInfo.nodeStyleArray[i]]) + nodeBaseProperty.borderWidth;
+			auto& rect = nodeRectArray[i];
+			rect = {pos.x - margin, pos.y - margin, pos.x + margin, pos.y + margin};
+			if(node->parent != nullptr)
+			{
+				auto const parentPos = getPos(node->parent);
+				auto const edgeMargin = (double)nodeBaseProperty.edgeWidth;
+				rect.x0 = std::min(rect.x0, std::min(pos.x, parentPos.x) - edgeMargin);
+				rect.y0 = std::min(rect.y0, std::min(pos.y, parentPos.y) - edgeMargin);
+				rect.x1 = std::max(rect.x1, std::max(pos.x, parentPos.x) + edgeMargin);
+				rect.y1 = std::max(rect.y1, std::max(pos.y, parentPos.y) + edgeMargin);
+			}
+		}
+
+		auto measureSurface = Cairo::ImageSurface::create(Cairo::Surface::Format::ARGB32, 1, 1);
+		auto measureContext = Cairo::Context::create(measureSurface);
+		measureContext->scale(scale, scale);
+		auto const& textRunArray = pageRuns.textRunArray;
+		std::string nodeLabel;
+		Cairo::TextExtents extents;
+		for(auto run = textRunArray.data(); run < textRunArray.data() + textRunArray.size(); ++run)
+		{
+			auto const& nodeProperty = getGroupProperty(run);
+			auto font = getFont(nodeProperty, TextCache::Metrics::Raster, scale);
+			measureContext->set_font_face(font->fontFace);
+			measureContext->set_font_size((double)nodeProperty.nodeExtendProperty.fontSize);
+			forEachNode(run, run + 1, [&](const NodeProperty& nodeProperty, const BiTreeParser::BiTreeNode* node, uint32_t index) {
+				auto const& text = getText(nodeProperty, node, nodeLabel);
+				if(text.empty())
+				{
+					return;
+				}
+
+				TextCache::getTextExtents(measureContext, font, text, extents);
+				auto& textBox = textBoxArray[index];
+				textBox.pos = getTextPos(getPos(node), extents);
+				textBox.rect = {textBox.pos.x + extents.x_bearing,
+								textBox.pos.y + extents.y_bearing,
+								textBox.pos.x + extents.x_bearing + extents.width,
+								textBox.pos.y + extents.y_bearing + extents.height};
+
+				auto& rect = nodeRectArray[index];
+				rect.x0 = std::min(rect.x0, textBox.rect.x0);
+				rect.y0 = std::min(rect.y0, textBox.rect.y0);
+				rect.x1 = std::max(rect.x1, textBox.rect.x1);
+				rect.y1 = std::max(rect.y1, textBox.rect.y1);
+			});
+		}
+
+		// Put each node to the tiles its rectangle overlaps, in the order of styleNodeArray,
+		// so the nodes of tile i are tileNodeArray[tileNodeOffsetArray[i], tileNodeOffsetArray[i+1]) sorted by style.
+		auto const tileCount = tileGrid.getTileCount();
+		std::vector<uint32_t> tileNodeOffsetArray(tileCount + 1, 0);
+		auto forEachTile = [&](uint32_t index, auto visit) {
+			auto const& rect = nodeRectArray[index];
+			auto const columnEnd = tileGrid.getColumn(rect.x1 * scale);
+			auto const rowEnd = tileGrid.getRow(rect.y1 * scale);
+			for(int row = tileGrid.getRow(rect.y0 * scale); row <= rowEnd; row++)
+			{
+				for(int column = tileGrid.getColumn(rect.x0 * scale); column <= columnEnd; column++)
+				{
+					visit(row * tileGrid.columnCount + column);
+				}
+			}
+		};
+		for(auto const& index : styleNodeArray)
+		{
+			forEachTile(index, [&](int tile) { ++tileNodeOffsetArray[tile + 1]; });
+		}
+		for(int i = 0; i < tileCount; i++)
+		{
+			tileNodeOffsetArray[i + 1] += tileNodeOffsetArray[i];
+		}
+		std::vector<uint32_t> tileNodeArray(tileNodeOffsetArray[tileCount]);
+		{
+			auto nextArray = tileNodeOffsetArray;
+			for(auto const& index : styleNodeArray)
+			{
+				forEachTile(index, [&](int tile) { tileNodeArray[nextArray[tile]++] = index; });
+			}
+		}
+
+		bool status = writeTiledPng(outputFile,
+									tileGrid,
+									scale,
+									[&](const Cairo::RefPtr<Cairo::Context>& cr, int tile, const PageRect& pageRect) {
+										auto const tileRuns = makePageRuns(tileNodeArray.data() + tileNodeOffsetArray[tile],
+																		   tileNodeArray.data() + tileNodeOffsetArray[tile + 1]);
+										drawPage(cr, tileRuns, TextCache::Metrics::Raster, scale, &pageRect, &textBoxArray);
+									});
+		if(!status)
+		{
+			return false;
+		}
+	}
+	else
+	{
+		auto cr = Cairo::Context::create(surface);
+		drawPage(cr, pageRuns, TextCache::Metrics::Page, 1.0, nullptr, nullptr);
+
+		// 003, get result.
+		cr->show_page();
+		if(outputFile == "-")
+		{
+			surface->finish();
+			fflush(stdout);
+		}
+	}
 	PrintInfo("Rendering bitree..........................ok\n\n");
 	PrintInfo("Output: [%s]\n",outputFile.c_str());
 
@@ -0,0 +1,257 @@
+/*
+The MIT License
+
+Copyright 2021 Krishna sssky307@163.com
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include "bitreeviz/BiTreeScanner.h"
+
+using namespace bitree;
+
+BiTreeScanner::BiTreeScanner(Listener* listener)
+	: mListener(listener)
+{ }
+
+bool BiTreeScanner::error(const char* message)
+{
+	PrintError("%s, at char %llu of the bitree.\n", message, (unsigned long long)mPosition);
+	mIsGood = false;
+	return false;
+}
+
+bool BiTreeScanner::put(const char& ch)
+{
+	if(!mIsGood)
+	{
+		return false;
+	}
+	++mPosition;
+
+	if(mIsInProperty)
+	{
+		mPropertyText.push_back(ch);
+		if(ch == '"')
+		{
+			mIsInQuote = !mIsInQuote;
+		}
+		else if(ch == '}' && !mIsInQuote)
+		{
+			return onPropertyEnd();
+		}
+		return true;
+	}
+
+	// This data just like a C language name.
+	if((ch >= '0' && ch <= '9') || (ch >= 'a' && ch <= 'z') || (ch >= 'A' && ch <= 'Z') || ch == '_')
+	{
+		if(mLabel.size() >= NodeDataStrLenMax)
+		{
+			return error("Found a token.size() overflow");
+		}
+		mLabel.push_back(ch);
+		return true;
+	}
+
+	if(!mLabel.empty() && !onToken(TokenName::Id))
+	{
+		return false;
+	}
+
+	if(ch <= 0x20)
+	{
+		return true;
+	}
+	else if(ch == '(')
+	{
+		return onToken(TokenName::Lp);
+	}
+	else if(ch == ')')
+	{
+		return onToken(TokenName::Rp);
+	}
+	else if(ch == ',')
+	{
+		return onToken(TokenName::Comma);
+	}
+	else if(ch == '{')
+	{
+		if(!mIsNodePending || mHasProperty)
+		{
+			return error("Found \"{\" not just after a node");
+		}
+		mIsInProperty = true;
+		mIsInQuote = false;
+		mPropertyText.assign(1, ch);
+		return true;
+	}
+
+	return error("Meet error char");
+}
+
+bool BiTreeScanner::onPropertyEnd()
+{
+	mIsInProperty = false;
+	mHasProperty = true;
+
+	if(mPropertyParser)
+	{
+		bool status = false;
+		const NodeInfo* nodeInfo = nullptr;
+		auto it = mPropertyParser->parsingInline(mPropertyText.cbegin(), mPropertyText.cend(), status, nodeInfo);
+		if(!status || it != mPropertyText.cend())
+		{
+			return error("Found invalid inline property");
+		}
+	}
+
+	return true;
+}
+
+void BiTreeScanner::setPropertyParser(BiTreeParser::BiTreePropertyParser* propertyParser)
+{
+	mPropertyParser = propertyParser;
+}
+
+bool BiTreeScanner::isInProperty() const
+{
+	return mIsInProperty;
+}
+
+bool BiTreeScanner::end()
+{
+	if(!mIsGood)
+	{
+		return false;
+	}
+	if(mIsInProperty)
+	{
+		return error("Found \"{\" without \"}\"");
+	}
+	if(!mLabel.empty() && !onToken(TokenName::Id))
+	{
+		return false;
+	}
+
+	return onToken(TokenName::End);
+}
+
+void BiTreeScanner::onChildDone()
+{
+	if(mStateStack.empty())
+	{
+		return; // It is the root.
+	}
+
+	auto& state = mStateStack.back();
+	if(state == State::ExpectLeft)
+	{
+		state = State::ExpectComma;
+	}
+	else if(state == State::ExpectRight)
+	{
+		state = State::ExpectRp;
+	}
+}
+
+bool BiTreeScanner::onToken(TokenName name)
+{
+	if(name == TokenName::Id)
+	{
+		if(mIsNodePending)
+		{
+			return error("Found two nodes without \"(\" or \",\" between them");
+		}
+
+		Listener::NodeSide side = Listener::NodeSide::Root;
+		if(mStateStack.empty())
+		{
+			if(mIsRootFound)
+			{
+				return error("Found more than one root node");
+			}
+			mIsRootFound = true;
+		}
+		else if(mStateStack.back() == State::ExpectLeft)
+		{
+			side = Listener::NodeSide::Left;
+		}
+		else if(mStateStack.back() == State::ExpectRight)
+		{
+			side = Listener::NodeSide::Right;
+		}
+		else
+		{
+			return error("Found a node at unexpected position");
+		}
+
+		if(mListener)
+		{
+			mListener->onNodeBegin(mLabel, (uint32_t)mStateStack.size(), side);
+		}
+		mLabel.clear();
+		mIsNodePending = true;
+		mHasProperty = false;
+
+		return true;
+	}
+
+	if(mIsNodePending)
+	{
+		mIsNodePending = false;
+		if(name == TokenName::Lp)
+		{
+			mStateStack.push_back(State::ExpectLeft);
+			return true;
+		}
+
+		// The node has no children.
+		if(mListener)
+		{
+			mListener->onNodeEnd((uint32_t)mStateStack.size());
+		}
+		onChildDone();
+	}
+
+	switch(name)
+	{
+	case TokenName::Comma:
+		if(mStateStack.empty() ||
+		   (mStateStack.back() != State::ExpectLeft && mStateStack.back() != State::ExpectComma))
+		{
+			return error("Found \",\" at unexpected position");
+		}
+		mStateStack.back() = State::ExpectRight;
+		return true;
+
+	case TokenName::Rp:
+		if(mStateStack.empty() ||
+		   (mStateStack.back() != State::ExpectRight && mStateStack.back() != State::ExpectRp))
+		{
+			return error("Found \")\" at unexpected position");
+		}
+		mStateStack.pop_back();
+		if(mListener)
+		{
+			mListener->onNodeEnd((uint32_t)mStateStack.size());
+		}
+		onChildDone();
+		return true;
+
+	case TokenName::End:
+		if(!mIsRootFound || !mStateStack.empty())
+		{
+			return error("The bitree is not complete");
+		}
+		return true;
+
+	default:
+		return error("Found \"(\" at unexpected position");
+	}
+}
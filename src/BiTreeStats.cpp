@@ -0,0 +1,107 @@
+/*
+The MIT License
+
+Copyright 2021 Krishna sssky307@163.com
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include "bitreeviz/BiTreeStats.h"
+
+#include <algorithm>
+#include <cstdio>
+
+using namespace bitree;
+
+void BiTreeStats::onNodeBegin(std::string_view label, uint32_t depth, NodeSide side)
+{
+	++nodeCount;
+	maxLabelSize = std::max(maxLabelSize, (uint32_t)label.size());
+
+	if(levelWidthArray.size() <= depth)
+	{
+		levelWidthArray.resize(depth + 1, 0);
+	}
+	++levelWidthArray[depth];
+
+	if(!mFrameStack.empty())
+	{
+		mFrameStack.back().hasChild = true;
+	}
+	mFrameStack.push_back({0, 0, side, false});
+}
+
+void BiTreeStats::onNodeEnd(uint32_t /*depth*/)
+{
+	BiTreeAssert(!mFrameStack.empty());
+	const Frame frame = mFrameStack.back();
+	mFrameStack.pop_back();
+
+	if(!frame.hasChild)
+	{
+		++leafCount;
+	}
+
+	const int64_t factor = (int64_t)frame.leftHeight - (int64_t)frame.rightHeight;
+	maxAbsBalanceFactor = std::max(maxAbsBalanceFactor, (uint64_t)(factor < 0 ? -factor : factor));
+
+	const uint32_t subTreeHeight = std::max(frame.leftHeight, frame.rightHeight) + 1;
+	if(mFrameStack.empty())
+	{
+		height = subTreeHeight;
+		balanceFactor = factor;
+	}
+	else if(frame.side == NodeSide::Left)
+	{
+		mFrameStack.back().leftHeight = subTreeHeight;
+	}
+	else
+	{
+		mFrameStack.back().rightHeight = subTreeHeight;
+	}
+}
+
+std::string BiTreeStats::toJson(const std::string& inputFile) const
+{
+	std::string json = "{\"file\":\"";
+	for(auto const& ch : inputFile)
+	{
+		if(ch == '"' || ch == '\\')
+		{
+			json += '\\';
+			json += ch;
+		}
+		else if((unsigned char)ch < 0x20)
+		{
+			char escaped[8];
+			snprintf(escaped, sizeof(escaped), "\\u%04x", (unsigned)ch);
+			json += escaped;
+		}
+		else
+		{
+			json += ch;
+		}
+	}
+	json += "\"";
+
+	json += ",\"nodeCount\":" + std::to_string(nodeCount);
+	json += ",\"height\":" + std::to_string(height);
+	json += ",\"leafCount\":" + std::to_string(leafCount);
+	json += ",\"levelWidths\":[";
+	for(std::size_t i = 0; i < levelWidthArray.size(); i++)
+	{
+		json += (i > 0 ? "," : "") + std::to_string(levelWidthArray[i]);
+	}
+	json += "]";
+	json += ",\"maxLabelSize\":" + std::to_string(maxLabelSize);
+	json += ",\"balanceFactor\":" + std::to_string(balanceFactor);
+	json += ",\"maxAbsBalanceFactor\":" + std::to_string(maxAbsBalanceFactor);
+	json += "}";
+
+	return json;
+}
@@ -0,0 +1,240 @@
+/*
+The MIT License
+
+Copyright 2021 Krishna sssky307@163.com
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include "bitreeviz/BiTreeStylesheet.h"
+#include "bitreeviz/BiTreeFileParser.h"
+#include "bitreeviz/BiTreeInputStream.h"
+
+#include <filesystem>
+
+using namespace bitree;
+
+std::map<std::string, std::shared_ptr<BiTreeStylesheet>> BiTreeStylesheet::mCache;
+std::recursive_mutex BiTreeStylesheet::mCacheMutex;
+
+static const std::string directive = "@include";
+
+bool BiTreeStylesheet::isIncludeLine(str_ptr_t begin, str_ptr_t end)
+{
+	if(end - begin < (std::ptrdiff_t)directive.size() || !std::equal(directive.begin(), directive.end(), begin))
+	{
+		return false;
+	}
+	begin += directive.size();
+
+	return begin == end || *begin <= 0x20 || *begin == '"';
+}
+
+str_ptr_t BiTreeStylesheet::getIncludeFile(str_ptr_t begin, str_ptr_t end, bool& status, std::string& file)
+{
+	status = false;
+	file.clear();
+
+	if(end - begin < (std::ptrdiff_t)directive.size() || !std::equal(directive.begin(), directive.end(), begin))
+	{
+		return begin;
+	}
+	begin += directive.size();
+	if(begin < end && *begin > 0x20 && *begin != '"')
+	{
+		return begin;
+	}
+
+	while(begin < end && *begin <= 0x20)
+		++begin;
+
+	if(begin < end && *begin == '"')
+	{
+		++begin;
+		while(begin < end && *begin != '"')
+		{
+			file.push_back(*begin);
+			++begin;
+		}
+		if(begin == end)
+		{
+			return begin;
+		}
+		++begin;
+	}
+	else
+	{
+		while(begin < end && *begin > 0x20 && *begin != ';' && *begin != ',')
+		{
+			file.push_back(*begin);
+			++begin;
+		}
+	}
+
+	// Only spaces and [,;] and notes can follow the file.
+	while(begin < end && (*begin <= 0x20 || *begin == ';' || *begin == ','))
+		++begin;
+	if(begin < end && *begin != '/' && *begin != '#')
+	{
+		return begin;
+	}
+
+	status = !file.empty();
+	return end;
+}
+
+std::string BiTreeStylesheet::resolvePath(const std::string& includingFile, const std::string& file)
+{
+	std::filesystem::path path(file);
+	if(path.is_relative())
+	{
+		path = std::filesystem::path(includingFile).parent_path() / path;
+	}
+
+	return path.lexically_normal().generic_string();
+}
+
+bool BiTreeStylesheet::getFileStamp(const std::string& file, FileStamp& fileStamp)
+{
+	std::error_code error;
+	auto fileTime = std::filesystem::last_write_time(file, error);
+	if(error)
+	{
+		return false;
+	}
+	auto fileSize = std::filesystem::file_size(file, error);
+	if(error)
+	{
+		return false;
+	}
+
+	fileStamp.file = file;
+	fileStamp.time = (int64_t)fileTime.time_since_epoch().count();
+	fileStamp.size = (uint64_t)fileSize;
+
+	return true;
+}
+
+bool BiTreeStylesheet::isModified() const
+{
+	FileStamp fileStamp;
+	for(auto const& stamp : mFileStampArray)
+	{
+		if(!getFileStamp(stamp.file, fileStamp) || fileStamp.time != stamp.time ||
+		   fileStamp.size != stamp.size)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+std::shared_ptr<const BiTreeStylesheet> BiTreeStylesheet::load(const std::string& file)
+{
+	// An included stylesheet is loaded by the same thread, so the mutex is recursive.
+	std::lock_guard<std::recursive_mutex> lock(mCacheMutex);
+
+	auto& cached = mCache[file];
+	if(cached && cached->mIsLoading)
+	{
+		PrintError("Found include cycle at stylesheet: [%s].\n", file.c_str());
+		return nullptr;
+	}
+	if(cached && cached->mIsGood && !cached->isModified())
+	{
+		return cached;
+	}
+
+	// The cached one may still be applied by other documents, so it is replaced instead of being parsed again.
+	PrintInfo("Parsing stylesheet: [%s]\n", file.c_str());
+	auto stylesheet = std::make_shared<BiTreeStylesheet>();
+	cached = stylesheet;
+	stylesheet->mIsLoading = true;
+	stylesheet->mIsGood = stylesheet->parsing(file);
+	stylesheet->mIsLoading = false;
+
+	if(!stylesheet->mIsGood)
+	{
+		PrintError("Parsing stylesheet: [%s] failed.\n", file.c_str());
+		return nullptr;
+	}
+
+	return stylesheet;
+}
+
+void BiTreeStylesheet::clearCache()
+{
+	std::lock_guard<std::recursive_mutex> lock(mCacheMutex);
+	mCache.clear();
+}
+
+const std::vector<BiTreeStylesheet::Record>& BiTreeStylesheet::getRecordArray() const
+{
+	return mRecordArray;
+}
+
+bool BiTreeStylesheet::parsing(const std::string& file)
+{
+	FileStamp fileStamp;
+	if(!getFileStamp(file, fileStamp))
+	{
+		PrintError("Cannot open file:[%s]\n", file.c_str());
+		return false;
+	}
+	mFileStampArray.push_back(fileStamp);
+
+	BiTreeInputStream inFile(file);
+	if(!inFile.open())
+	{
+		return false;
+	}
+
+	BiTreeParser::BiTreePropertyParser propertyParser;
+	propertyParser.setRecordArray(&mRecordArray);
+
+	bool status = true;
+	for(std::string line; status && inFile.getLine(line);)
+	{
+		str_ptr_t begin = line.begin();
+		str_ptr_t end = line.end();
+
+		begin = BiTreeFileParser::trimLine(begin, end);
+		if(begin >= end)
+			continue;
+
+		// A stylesheet can include other stylesheets too.
+		if(isIncludeLine(begin, line.cend()))
+		{
+			std::string includeFile;
+			BiTreeStylesheet::getIncludeFile(begin, line.cend(), status, includeFile);
+			if(!status)
+			{
+				PrintError("Invalid include line: [%s].\n", line.c_str());
+				break;
+			}
+
+			auto included = load(resolvePath(file, includeFile));
+			if(included == nullptr)
+			{
+				status = false;
+				break;
+			}
+			mRecordArray.insert(
+				mRecordArray.end(), included->mRecordArray.begin(), included->mRecordArray.end());
+			mFileStampArray.insert(mFileStampArray.end(),
+								   included->mFileStampArray.begin(),
+								   included->mFileStampArray.end());
+			continue;
+		}
+
+		status = propertyParser.parsing(begin, end);
+	}
+
+	return status && inFile.good();
+}
@@ -37,9 +37,10 @@ BiTreeViz::BiTreeViz(const std::string& inputFile, const std::string& outputFile
 {
     mInputFile = convertSlash(inputFile);
 
-    if(mOutputfile.empty())
+    if(outputFile.empty())
     {
-        mOutputfile = mInputFile + ".pdf";
+        // Read from stdin, so write to stdout.
+        mOutputfile = (mInputFile == "-" ? "-" : mInputFile + ".pdf");
     }
     else
     {
@@ -83,18 +84,100 @@ bool BiTreeViz::run()
     BiTreeAssert(mRenderer == nullptr);
     mRenderer = new BiTreeRenderer();
     BiTreeAssert(mRenderer != nullptr);
+    mRenderer->setDpi(mDpi);
+
+    // The rendered file is written to stdout, so the logs go to stderr.
+    FILE* printStream = PrintStream();
+    if(mOutputfile == "-")
+    {
+        PrintStream() = stderr;
+    }
 
     if(mFileParser->parsing())
     {
-        status = mRenderer->draw(
-            mFileParser->getNodeInfoArray(), mFileParser->getLayoutInfo(), mOutputfile);
+        status = mRenderer->draw(mFileParser->getLayoutInfo(), mOutputfile);
+    }
+
+    PrintInfo("Done.\n");
+    PrintStream() = printStream;
+
+    return status;
+}
+
+void BiTreeViz::setDpi(const uint32_t& dpi)
+{
+    BiTreeAssert(dpi >= PngDpiMin && dpi <= PngDpiMax);
+    mDpi = dpi;
+}
+
+bool BiTreeViz::check(const std::vector<std::string>& inputFiles)
+{
+    std::size_t failedCount = 0;
+
+    for(auto const& inputFile : inputFiles)
+    {
+        BiTreeFileParser fileParser(convertSlash(inputFile));
+        if(fileParser.checking())
+        {
+            PrintInfo("Check file: [%s].........ok\n", inputFile.c_str());
+        }
+        else
+        {
+            PrintInfo("Check file: [%s].........failed\n", inputFile.c_str());
+            ++failedCount;
+        }
+    }
+
+    PrintInfo("Checked %zu file(s), %zu failed.\n", inputFiles.size(), failedCount);
+
+    return failedCount == 0;
+}
+
+bool BiTreeViz::stats(const std::vector<std::string>& inputFiles)
+{
+    bool status = true;
+
+    // Only the JSON is written to stdout.
+    FILE* printStream = PrintStream();
+    PrintStream() = stderr;
+
+    for(auto const& inputFile : inputFiles)
+    {
+        BiTreeStats treeStats;
+        BiTreeFileParser fileParser(convertSlash(inputFile));
+        if(fileParser.statistics(treeStats))
+        {
+            printf("%s\n", treeStats.toJson(inputFile).c_str());
+        }
+        else
+        {
+            status = false;
+        }
     }
 
-    PrintInfo("Done.");
+    PrintStream() = printStream;
 
     return status;
 }
 
+bool BiTreeViz::batch(const std::vector<std::string>& inputFiles)
+{
+    std::size_t failedCount = 0;
+
+    for(auto const& inputFile : inputFiles)
+    {
+        BiTreeViz bitreeViz(inputFile);
+        if(!bitreeViz.run())
+        {
+            ++failedCount;
+        }
+    }
+
+    PrintInfo("Rendered %zu file(s), %zu failed.\n", inputFiles.size(), failedCount);
+
+    return failedCount == 0;
+}
+
 void BiTreeViz::ShowHelp()
 {
     static const std::string usageStr = 
@@ -102,6 +185,14 @@ void BiTreeViz::ShowHelp()
                                        --from Krsihna, sssky307@163.com 
 Usage:
   bitreeviz.exe <file> [-o <file2>]    //Read <file>, output to [<file2>].
+                                       //<file> or <file2> can be "-" for stdin or stdout.
+                                       //<file2> is a png if it ends with ".png",
+                                       //or a svg if it ends with ".svg".
+  bitreeviz.exe <file> -o <file2.png> --dpi <n>
+                                       //Output a png of <n> dots per inch, 18 to 1200, 96 by default.
+  bitreeviz.exe --check <file>...      //Only check <file>(s), output nothing.
+  bitreeviz.exe --stats <file>...      //Print statistics of <file>(s) as JSON.
+  bitreeviz.exe --batch <file>...      //Read each <file>, output to <file>.pdf.
   bitreeviz.exe --help                 //Show this help.
   bitreeviz.exe --version              //Show version.
 )~";